@@ -42,8 +42,14 @@ if( NOT GT_GCL_ONLY )
     if( GT_USE_MPI )
         add_library( mpi_gtest_main include/gridtools/tools/mpi_unit_test_driver/mpi_test_driver.cpp )
         target_link_libraries(mpi_gtest_main gtest GridToolsTest gcl)
+        # for the tests that start the communication progress thread
+        add_library( mpi_gtest_main_thread_multiple include/gridtools/tools/mpi_unit_test_driver/mpi_test_driver.cpp )
+        target_link_libraries(mpi_gtest_main_thread_multiple gtest GridToolsTest gcl)
+        target_compile_definitions(mpi_gtest_main_thread_multiple PRIVATE GT_MPI_THREAD_MULTIPLE)
         if (GT_ENABLE_BACKEND_CUDA)
-            target_include_directories( mpi_gtest_main PRIVATE ${CMAKE_CUDA_TOOLKIT_INCLUDE_DIRECTORIES} )
+            foreach(main mpi_gtest_main mpi_gtest_main_thread_multiple)
+                target_include_directories( ${main} PRIVATE ${CMAKE_CUDA_TOOLKIT_INCLUDE_DIRECTORIES} )
+            endforeach()
         endif()
     endif()
 endif()
@@ -149,7 +155,7 @@ function(add_custom_test target_arch)
 endfunction()
 
 function(add_custom_mpi_test target_arch)
-    set(options)
+    set(options THREAD_MULTIPLE)
     set(one_value_args TARGET NPROC)
     set(multi_value_args SOURCES COMPILE_DEFINITIONS LABELS)
     cmake_parse_arguments(__ "${options}" "${one_value_args}" "${multi_value_args}" ${ARGN})
@@ -177,7 +183,11 @@ function(add_custom_mpi_test target_arch)
         set(unit_test "${___TARGET}_${target_arch_l}")
         # create the test
         add_executable (${unit_test} ${___SOURCES})
-        target_link_libraries(${unit_test} gmock mpi_gtest_main GridToolsTest${target_arch_u})
+        if (___THREAD_MULTIPLE)
+            target_link_libraries(${unit_test} gmock mpi_gtest_main_thread_multiple GridToolsTest${target_arch_u})
+        else()
+            target_link_libraries(${unit_test} gmock mpi_gtest_main GridToolsTest${target_arch_u})
+        endif()
         target_compile_definitions(${unit_test} PRIVATE ${___COMPILE_DEFINITIONS})
         gridtools_add_mpi_test(
             NAME ${unit_test}
@@ -9,9 +9,12 @@
  */
 #pragma once
 
+#include <algorithm>
+
 #include "../common/array.hpp"
 #include "../common/defs.hpp"
 #include "../common/halo_descriptor.hpp"
+#include "../common/omp.hpp"
 #include "direction.hpp"
 #include "predicate.hpp"
 
@@ -35,24 +38,66 @@ namespace gridtools {
         BoundaryFunction const boundary_function;
         Predicate predicate;
 
-        /** @brief loops on the halo region defined by the HaloDescriptor member parameter, and evaluates the
-           boundary_function in the specified direction, in the specified halo node.
-            this macro expands to n definitions of the function loop, taking a number of arguments ranging from 0 to n
-           (DataField0, Datafield1, DataField2, ...)*/
-        template <typename Direction, typename... DataField>
-        void loop(DataField &... data_field) const {
-            const int_t i_low = halo_descriptors[0].loop_low_bound_outside(Direction::i);
-            const int_t i_high = halo_descriptors[0].loop_high_bound_outside(Direction::i);
-            const int_t j_low = halo_descriptors[1].loop_low_bound_outside(Direction::j);
-            const int_t j_high = halo_descriptors[1].loop_high_bound_outside(Direction::j);
-            const int_t k_low = halo_descriptors[2].loop_low_bound_outside(Direction::k);
-            const int_t k_high = halo_descriptors[2].loop_high_bound_outside(Direction::k);
-
-#pragma omp parallel for simd collapse(3)
-            for (int_t j = j_low; j <= j_high; ++j)
-                for (int_t k = k_low; k <= k_high; ++k)
-                    for (int_t i = i_low; i <= i_high; ++i)
-                        boundary_function(Direction(), data_field..., i, j, k);
+        template <typename... DataFieldViews>
+        struct region;
+
+        template <typename... DataFieldViews>
+        using loop_type = void (boundary_apply::*)(
+            region<DataFieldViews...> const &, int_t, int_t, DataFieldViews const &...) const;
+
+        /* Halo region of one direction, a box of points numbered with i running fastest, then k, then j. */
+        template <typename... DataFieldViews>
+        struct region {
+            loop_type<DataFieldViews...> loop;
+            int_t low[3];
+            int_t length[3];
+            int_t begin; // number of points in the regions before this one
+            int_t size;
+        };
+
+        template <typename Direction, typename... DataFieldViews>
+        void add_region(array<region<DataFieldViews...>, 26> &regions, int_t &count, int_t &total) const {
+            region<DataFieldViews...> &r = regions[count];
+            r.loop = &boundary_apply::loop<Direction, DataFieldViews...>;
+            r.low[0] = halo_descriptors[0].loop_low_bound_outside(Direction::i);
+            r.low[1] = halo_descriptors[1].loop_low_bound_outside(Direction::j);
+            r.low[2] = halo_descriptors[2].loop_low_bound_outside(Direction::k);
+            r.length[0] = halo_descriptors[0].loop_high_bound_outside(Direction::i) - r.low[0] + 1;
+            r.length[1] = halo_descriptors[1].loop_high_bound_outside(Direction::j) - r.low[1] + 1;
+            r.length[2] = halo_descriptors[2].loop_high_bound_outside(Direction::k) - r.low[2] + 1;
+            r.size = r.length[0] > 0 && r.length[1] > 0 && r.length[2] > 0 ? r.length[0] * r.length[1] * r.length[2]
+                                                                           : 0;
+            if (r.size == 0)
+                return;
+            r.begin = total;
+            total += r.size;
+            ++count;
+        }
+
+        /** @brief evaluates the boundary_function in the specified direction on the points [first, last) of the
+           halo region r. */
+        template <typename Direction, typename... DataFieldViews>
+        void loop(region<DataFieldViews...> const &r,
+            int_t first,
+            int_t last,
+            DataFieldViews const &... data_field_views) const {
+            int_t i = first % r.length[0];
+            int_t k = first / r.length[0] % r.length[2];
+            int_t j = first / (r.length[0] * r.length[2]);
+            for (int_t p = first; p < last;) {
+                const int_t i_end = std::min(r.length[0], i + last - p);
+                const int_t jj = r.low[1] + j;
+                const int_t kk = r.low[2] + k;
+#pragma omp simd
+                for (int_t ii = r.low[0] + i; ii < r.low[0] + i_end; ++ii)
+                    boundary_function(Direction(), data_field_views..., ii, jj, kk);
+                p += i_end - i;
+                i = 0;
+                if (++k == r.length[2]) {
+                    k = 0;
+                    ++j;
+                }
+            }
         }
 
       public:
@@ -71,69 +116,91 @@ namespace gridtools {
         */
         template <typename... DataFieldViews>
         void apply(DataFieldViews const &... data_field_views) const {
+            // the halo regions of all the active directions are flattened in a single list of points, that is split
+            // evenly among the threads of a single parallel region
+            array<region<DataFieldViews...>, 26> regions;
+            int_t count = 0;
+            int_t total = 0;
 
             if (predicate(direction<minus_, minus_, minus_>()))
-                this->loop<direction<minus_, minus_, minus_>>(data_field_views...);
+                add_region<direction<minus_, minus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, minus_, zero_>()))
-                this->loop<direction<minus_, minus_, zero_>>(data_field_views...);
+                add_region<direction<minus_, minus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, minus_, plus_>()))
-                this->loop<direction<minus_, minus_, plus_>>(data_field_views...);
+                add_region<direction<minus_, minus_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<minus_, zero_, minus_>()))
-                this->loop<direction<minus_, zero_, minus_>>(data_field_views...);
+                add_region<direction<minus_, zero_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, zero_, zero_>()))
-                this->loop<direction<minus_, zero_, zero_>>(data_field_views...);
+                add_region<direction<minus_, zero_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, zero_, plus_>()))
-                this->loop<direction<minus_, zero_, plus_>>(data_field_views...);
+                add_region<direction<minus_, zero_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<minus_, plus_, minus_>()))
-                this->loop<direction<minus_, plus_, minus_>>(data_field_views...);
+                add_region<direction<minus_, plus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, plus_, zero_>()))
-                this->loop<direction<minus_, plus_, zero_>>(data_field_views...);
+                add_region<direction<minus_, plus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<minus_, plus_, plus_>()))
-                this->loop<direction<minus_, plus_, plus_>>(data_field_views...);
+                add_region<direction<minus_, plus_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<zero_, minus_, minus_>()))
-                this->loop<direction<zero_, minus_, minus_>>(data_field_views...);
+                add_region<direction<zero_, minus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<zero_, minus_, zero_>()))
-                this->loop<direction<zero_, minus_, zero_>>(data_field_views...);
+                add_region<direction<zero_, minus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<zero_, minus_, plus_>()))
-                this->loop<direction<zero_, minus_, plus_>>(data_field_views...);
+                add_region<direction<zero_, minus_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<zero_, zero_, minus_>()))
-                this->loop<direction<zero_, zero_, minus_>>(data_field_views...);
+                add_region<direction<zero_, zero_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<zero_, zero_, plus_>()))
-                this->loop<direction<zero_, zero_, plus_>>(data_field_views...);
+                add_region<direction<zero_, zero_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<zero_, plus_, minus_>()))
-                this->loop<direction<zero_, plus_, minus_>>(data_field_views...);
+                add_region<direction<zero_, plus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<zero_, plus_, zero_>()))
-                this->loop<direction<zero_, plus_, zero_>>(data_field_views...);
+                add_region<direction<zero_, plus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<zero_, plus_, plus_>()))
-                this->loop<direction<zero_, plus_, plus_>>(data_field_views...);
+                add_region<direction<zero_, plus_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<plus_, minus_, minus_>()))
-                this->loop<direction<plus_, minus_, minus_>>(data_field_views...);
+                add_region<direction<plus_, minus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, minus_, zero_>()))
-                this->loop<direction<plus_, minus_, zero_>>(data_field_views...);
+                add_region<direction<plus_, minus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, minus_, plus_>()))
-                this->loop<direction<plus_, minus_, plus_>>(data_field_views...);
+                add_region<direction<plus_, minus_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<plus_, zero_, minus_>()))
-                this->loop<direction<plus_, zero_, minus_>>(data_field_views...);
+                add_region<direction<plus_, zero_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, zero_, zero_>()))
-                this->loop<direction<plus_, zero_, zero_>>(data_field_views...);
+                add_region<direction<plus_, zero_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, zero_, plus_>()))
-                this->loop<direction<plus_, zero_, plus_>>(data_field_views...);
+                add_region<direction<plus_, zero_, plus_>, DataFieldViews...>(regions, count, total);
 
             if (predicate(direction<plus_, plus_, minus_>()))
-                this->loop<direction<plus_, plus_, minus_>>(data_field_views...);
+                add_region<direction<plus_, plus_, minus_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, plus_, zero_>()))
-                this->loop<direction<plus_, plus_, zero_>>(data_field_views...);
+                add_region<direction<plus_, plus_, zero_>, DataFieldViews...>(regions, count, total);
             if (predicate(direction<plus_, plus_, plus_>()))
-                this->loop<direction<plus_, plus_, plus_>>(data_field_views...);
-
-            // apply(data_field_views ...);
+                add_region<direction<plus_, plus_, plus_>, DataFieldViews...>(regions, count, total);
+
+            if (total == 0)
+                return;
+
+#pragma omp parallel
+            {
+                const int_t threads = omp_get_num_threads();
+                const int_t thread = omp_get_thread_num();
+                int_t first = total * thread / threads;
+                const int_t last = total * (thread + 1) / threads;
+                for (int_t n = 0; n < count && first < last; ++n) {
+                    region<DataFieldViews...> const &r = regions[n];
+                    if (r.begin + r.size <= first)
+                        continue;
+                    const int_t region_last = std::min(last, r.begin + r.size);
+                    (this->*r.loop)(r, first - r.begin, region_last - r.begin, data_field_views...);
+                    first = region_last;
+                }
+            }
         }
 
       private:
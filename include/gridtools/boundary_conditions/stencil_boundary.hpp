@@ -0,0 +1,229 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <utility>
+
+#include "../common/array.hpp"
+#include "../common/defs.hpp"
+#include "../common/halo_descriptor.hpp"
+#include "../common/host_device.hpp"
+#include "../stencil_composition/cartesian.hpp"
+#include "../stencil_composition/global_parameter.hpp"
+#include "../stencil_composition/positional.hpp"
+#include "../storage/sid.hpp"
+#include "direction.hpp"
+#include "predicate.hpp"
+
+/**
+@file
+@brief Application of the boundary conditions by the stencil backends.
+
+The boundary functors (value_boundary, copy_boundary, zero_boundary, user functors) are executed as stages of
+computations restricted to the halo regions, so that the backend provides the blocking, the thread placement and the
+vectorization of the loops, instead of the plain loops of boundary_apply.
+*/
+namespace gridtools {
+    namespace _impl {
+        /** The k axis of the boundary computations: the points below the halo, the minus halo, the compute domain and
+         * the plus halo. */
+        using boundary_axis_t = axis<4>;
+
+        template <sign K>
+        using boundary_interval_t = boundary_axis_t::get_interval<K + 2>;
+
+        template <sign K>
+        GT_FUNCTION GT_CONSTEXPR int boundary_k_bit() {
+            return 1 << (K + 1);
+        }
+
+        /** The boundary functor and the k directions to which it is applied in the current ij region. */
+        template <typename BoundaryFunction>
+        struct boundary_parameter {
+            BoundaryFunction function;
+            int active_k;
+        };
+
+        /** Gives the boundary functors the data_field(i, j, k) interface, in absolute indices, on top of an accessor.
+         */
+        template <typename Evaluation, typename Accessor>
+        struct boundary_field_proxy {
+            Evaluation &m_eval;
+            int_t m_i;
+            int_t m_j;
+            int_t m_k;
+
+            GT_FUNCTION decltype(auto) operator()(uint_t i, uint_t j, uint_t k) const {
+                return m_eval(Accessor((int_t)i - m_i, (int_t)j - m_j, (int_t)k - m_k));
+            }
+        };
+
+        template <sign I, sign J, typename Extent, typename Indices>
+        struct boundary_stage;
+
+        /**
+           Stage applying the boundary functor on the halo region (I, J) in i and j. The k directions are the
+           intervals of boundary_axis_t, the interior one is omitted for the (zero_, zero_) region. The fields can be
+           accessed within Extent around the current point.
+         */
+        template <sign I, sign J, typename Extent, size_t... Is>
+        struct boundary_stage<I, J, Extent, std::index_sequence<Is...>> {
+            using parameter = cartesian::in_accessor<0>;
+            using i_pos = cartesian::in_accessor<1>;
+            using j_pos = cartesian::in_accessor<2>;
+            using k_pos = cartesian::in_accessor<3>;
+            template <size_t N>
+            using field = cartesian::inout_accessor<4 + N, Extent, 3>;
+
+            using param_list = make_param_list<parameter, i_pos, j_pos, k_pos, field<Is>...>;
+
+          private:
+            template <typename Direction, typename BoundaryFunction, typename... Fields>
+            GT_FUNCTION static void call(
+                BoundaryFunction const &function, int_t i, int_t j, int_t k, Fields... fields) {
+                function(Direction(), fields..., i, j, k);
+            }
+
+            template <sign K, typename Evaluation>
+            GT_FUNCTION static void apply_direction(Evaluation &eval) {
+                auto const &param = eval(parameter());
+                if (!(param.active_k & boundary_k_bit<K>()))
+                    return;
+                int_t i = eval(i_pos());
+                int_t j = eval(j_pos());
+                int_t k = eval(k_pos());
+                call<direction<I, J, K>>(
+                    param.function, i, j, k, boundary_field_proxy<Evaluation, field<Is>>{eval, i, j, k}...);
+            }
+
+          public:
+            template <typename Evaluation>
+            GT_FUNCTION static void apply(Evaluation eval, boundary_interval_t<minus_>) {
+                apply_direction<minus_>(eval);
+            }
+
+            template <typename Evaluation, sign II = I, std::enable_if_t<II != zero_ || J != zero_, int> = 0>
+            GT_FUNCTION static void apply(Evaluation eval, boundary_interval_t<zero_>) {
+                apply_direction<zero_>(eval);
+            }
+
+            template <typename Evaluation>
+            GT_FUNCTION static void apply(Evaluation eval, boundary_interval_t<plus_>) {
+                apply_direction<plus_>(eval);
+            }
+        };
+    } // namespace _impl
+
+    /** \ingroup Boundary-Conditions
+     * @{
+     */
+
+    /**
+       @brief Boundary condition application by a stencil backend.
+
+       Same interface as boundary, but the boundary functor is executed by Backend: each of the nine halo regions in
+       the i and j dimensions is a computation with a single stage, whose k intervals are the halo regions in k. The
+       functor is called with the same arguments as by boundary_apply, the data_field(i, j, k) calls are translated
+       to accesses relative to the current point. Functors that read other points than (i, j, k) have to declare the
+       maximal offset as Extent.
+
+       The fields are passed as for run(), i.e. data stores or other SIDs.
+
+       \tparam BoundaryFunction The boundary condition functor, it has to be trivially copyable
+       \tparam Backend The stencil backend (e.g., x86::backend<>, mc::backend<>)
+       \tparam Predicate Runtime predicate for deciding if to apply boundary conditions or not on certain regions
+       \tparam Extent The extent of the accesses of the functor to the fields
+     */
+    template <typename BoundaryFunction, class Backend, typename Predicate = default_predicate, class Extent = extent<>>
+    struct stencil_boundary {
+      private:
+        array<halo_descriptor, 3> m_halo_descriptors;
+        BoundaryFunction m_boundary_function;
+        Predicate m_predicate;
+        Backend m_backend;
+
+        template <sign I, sign J, sign K>
+        bool active(direction<I, J, K> dir) const {
+            return m_predicate(dir);
+        }
+
+        bool active(direction<zero_, zero_, zero_>) const { return false; }
+
+        template <sign I, sign J>
+        int active_k() const {
+            return (active(direction<I, J, minus_>()) ? _impl::boundary_k_bit<minus_>() : 0) |
+                   (active(direction<I, J, zero_>()) ? _impl::boundary_k_bit<zero_>() : 0) |
+                   (active(direction<I, J, plus_>()) ? _impl::boundary_k_bit<plus_>() : 0);
+        }
+
+        template <sign I, sign J, typename... DataFields>
+        void apply_region(_impl::boundary_axis_t const &axis, DataFields &... data_fields) const {
+            int active = active_k<I, J>();
+            if (!active)
+                return;
+            int_t i_low = m_halo_descriptors[0].loop_low_bound_outside(I);
+            int_t i_size = m_halo_descriptors[0].loop_high_bound_outside(I) - i_low + 1;
+            int_t j_low = m_halo_descriptors[1].loop_low_bound_outside(J);
+            int_t j_size = m_halo_descriptors[1].loop_high_bound_outside(J) - j_low + 1;
+            if (i_size <= 0 || j_size <= 0)
+                return;
+
+            using stage_t = _impl::boundary_stage<I, J, Extent, std::index_sequence_for<DataFields...>>;
+            run(
+                [](auto parameter, auto i_pos, auto j_pos, auto k_pos, auto... fields) {
+                    return execute_parallel().stage(stage_t(), parameter, i_pos, j_pos, k_pos, fields...);
+                },
+                m_backend,
+                core::grid<_impl::boundary_axis_t::axis_interval_t>(
+                    i_low, i_size, j_low, j_size, axis.interval_sizes()),
+                make_global_parameter(_impl::boundary_parameter<BoundaryFunction>{m_boundary_function, active}),
+                positional<dim::i>(),
+                positional<dim::j>(),
+                positional<dim::k>(),
+                data_fields...);
+        }
+
+      public:
+        stencil_boundary(array<halo_descriptor, 3> const &hd,
+            BoundaryFunction const &boundary_f,
+            Predicate predicate = Predicate(),
+            Backend backend = Backend())
+            : m_halo_descriptors(hd), m_boundary_function(boundary_f), m_predicate(predicate), m_backend(backend) {}
+
+        template <typename... DataFields>
+        void apply(DataFields &... data_fields) const {
+            halo_descriptor const &k = m_halo_descriptors[2];
+            int_t k_minus_low = k.loop_low_bound_outside(minus_);
+            _impl::boundary_axis_t axis(k_minus_low,
+                k.loop_high_bound_outside(minus_) - k_minus_low + 1,
+                k.loop_high_bound_outside(zero_) - k.loop_low_bound_outside(zero_) + 1,
+                k.loop_high_bound_outside(plus_) - k.loop_low_bound_outside(plus_) + 1);
+
+            apply_region<minus_, minus_>(axis, data_fields...);
+            apply_region<minus_, zero_>(axis, data_fields...);
+            apply_region<minus_, plus_>(axis, data_fields...);
+            apply_region<zero_, minus_>(axis, data_fields...);
+            apply_region<zero_, zero_>(axis, data_fields...);
+            apply_region<zero_, plus_>(axis, data_fields...);
+            apply_region<plus_, minus_>(axis, data_fields...);
+            apply_region<plus_, zero_>(axis, data_fields...);
+            apply_region<plus_, plus_>(axis, data_fields...);
+        }
+    };
+
+    template <class Backend, class BoundaryFunction, class Predicate = default_predicate>
+    auto make_stencil_boundary(
+        array<halo_descriptor, 3> const &hd, BoundaryFunction &&boundary_f, Predicate &&predicate = Predicate()) {
+        return stencil_boundary<std::decay_t<BoundaryFunction>, Backend, std::decay_t<Predicate>>(
+            hd, std::forward<BoundaryFunction>(boundary_f), std::forward<Predicate>(predicate));
+    }
+
+    /** @} */
+} // namespace gridtools
@@ -0,0 +1,35 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace gridtools {
+    /**
+     * @brief Size of the (per core) L2 cache of the host in bytes.
+     *
+     * Falls back to 1 MiB if the size can not be queried from the system.
+     */
+    inline std::size_t l2_cache_size() {
+        static std::size_t const size = [] {
+            long res = 0;
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+            res = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+            return res > 0 ? std::size_t(res) : std::size_t(1) << 20;
+        }();
+        return size;
+    }
+} // namespace gridtools
@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <cstdlib>
+#include <memory>
 #include <new>
 
 namespace gridtools {
@@ -48,4 +49,17 @@ namespace gridtools {
         free(ptr);
     }
 
+    struct hugepage_deleter {
+        void operator()(void *ptr) const { hugepage_free(ptr); }
+    };
+
+    /**
+     * @brief Allocation functor for the `sid` allocators, returns huge page memory owned by a `std::unique_ptr`.
+     */
+    struct make_hugepage_unique_f {
+        std::unique_ptr<void, hugepage_deleter> operator()(std::size_t size) const {
+            return std::unique_ptr<void, hugepage_deleter>(hugepage_alloc(size));
+        }
+    };
+
 } // namespace gridtools
@@ -0,0 +1,85 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "omp.hpp"
+
+namespace gridtools {
+    namespace numa_impl_ {
+        constexpr std::size_t page_size = 4096;
+
+        inline std::uintptr_t page_begin(void const *ptr) {
+            return reinterpret_cast<std::uintptr_t>(ptr) / page_size * page_size;
+        }
+    } // namespace numa_impl_
+
+    /**
+     * @brief Touches every memory page of the given range from the calling thread.
+     *
+     * On systems with a first-touch policy (the default on Linux), this places all touched pages on the NUMA node of
+     * the calling thread. The content of the memory range is not preserved.
+     */
+    inline void numa_touch(void *ptr, std::size_t size) {
+        if (!size)
+            return;
+        char *first = static_cast<char *>(ptr);
+        char *last = first + size;
+        for (std::uintptr_t page = numa_impl_::page_begin(first); page < reinterpret_cast<std::uintptr_t>(last);
+             page += numa_impl_::page_size) {
+            char *p = reinterpret_cast<char *>(page);
+            *(p < first ? first : p) = 0;
+        }
+    }
+
+    /**
+     * @brief Touches the given memory range in parallel, such that the `t`-th of `omp_get_max_threads()` equally sized
+     * contiguous chunks is touched by thread `t`.
+     *
+     * This approximates the decomposition of the mc backend, which assigns contiguous chunks along the outermost
+     * storage dimension to consecutive threads: halos, padding, additional dimensions, dynamic schedules and the
+     * block sizes shift the chunks of the computation against the ones touched here. The content of the memory range
+     * is not preserved.
+     */
+    inline void numa_first_touch(void *ptr, std::size_t size) {
+        int threads = omp_get_max_threads();
+        std::size_t chunk = (size + threads - 1) / threads;
+#pragma omp parallel for schedule(static, 1)
+        for (int t = 0; t < threads; ++t) {
+            std::size_t begin = t * chunk;
+            if (begin < size)
+                numa_touch(static_cast<char *>(ptr) + begin, begin + chunk < size ? chunk : size - begin);
+        }
+    }
+
+    /**
+     * @brief Returns the NUMA node on which the memory page containing `ptr` resides.
+     *
+     * Returns -1 if the placement is unknown, that is if the page was not touched yet or if the system does not
+     * support querying page placement.
+     */
+    inline int numa_node(void const *ptr) {
+#if defined(__linux__) && defined(SYS_move_pages)
+        void *page = reinterpret_cast<void *>(numa_impl_::page_begin(ptr));
+        int status = -1;
+        if (syscall(SYS_move_pages, 0, 1ul, &page, nullptr, &status, 0) == 0 && status >= 0)
+            return status;
+#endif
+        return -1;
+    }
+} // namespace gridtools
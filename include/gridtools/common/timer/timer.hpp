@@ -53,6 +53,11 @@ namespace gridtools {
             m_counter++;
         }
 
+        /**
+         * Pause the stop watch without counting a call, for a call measured in several parts
+         */
+        void suspend() { m_total_time += m_impl.pause_impl(); }
+
         /**
          * @return total elapsed time [s]
          */
@@ -62,8 +62,24 @@ namespace gridtools {
     extern int PID;
     extern int PROCS;
 
+    /** How the non-blocking messages of the halo exchange patterns progress between start_exchange and wait. */
+    enum class gcl_progress {
+        in_mpi_calls,    // only inside the MPI calls made by the patterns, which is the default
+        dedicated_thread // a thread, taking one core from the OpenMP team, tests the outstanding requests
+    };
+
     void GCL_Init(int argc, char **argv);
 
+    /** Same as GCL_Init(argc, argv), with the choice of how the communication progresses. A dedicated progress
+        thread requires MPI_THREAD_MULTIPLE: MPI is initialized with it if not already initialized, otherwise the
+        thread is not started (with a warning) unless MPI was initialized with that level.
+
+        Side effect: while the progress thread runs, the default number of OpenMP threads of the process is reduced
+        by one with omp_set_num_threads, and restored by GCL_Finalize. Code that sets the number of threads itself
+        should do so after this call.
+     */
+    void GCL_Init(int argc, char **argv, gcl_progress progress);
+
     void GCL_Init();
 
     void GCL_Finalize();
@@ -278,18 +278,19 @@ namespace gridtools {
            Function to setup internal data structures for data exchange and preparing eventual underlying layers
 
            \param max_fields_n Maximum number of data fields that will be passed to the communication functions
+           \param mode How the halos are exchanged, see halo_exchange_mode
         */
-        void setup(int max_fields_n) {
-            hd.setup(max_fields_n);
+        void setup(int max_fields_n, halo_exchange_mode mode = halo_exchange_mode::all_neighbors) {
+            hd.setup(max_fields_n, mode);
 #ifdef GCL_TRACE
-            stats_collector<DIMS>::instance()->init(hd.pattern().proc_grid().communicator);
+            stats_collector<DIMS>::instance()->init(hd.pattern().proc_grid().communicator());
             std::vector<int> map = proc_map<layout_map, DIMS>::map();
             int coords[DIMS];
             int dims[DIMS];
             hd.pattern().proc_grid().coords(coords[0], coords[1], coords[2]);
             hd.pattern().proc_grid().dims(dims[0], dims[1], dims[2]);
             pattern_tag = stats_collector<DIMS>::instance()->add_pattern(
-                Pattern<DIMS>(pt_dynamic, hd.halo.halos, map, periodicity, coords, dims));
+                Pattern<DIMS>(pt_dynamic, hd.halo.halos, map, hd.pattern().proc_grid().cyclic(), coords, dims));
             hd.set_pattern_tag(pattern_tag);
 #endif
         }
@@ -327,7 +328,18 @@ namespace gridtools {
         */
         template <typename... FIELDS>
         void pack(const FIELDS *... _fields) {
+#ifdef GCL_TRACE
+            double start_time = MPI_Wtime();
+#endif
             hd.pack(_fields...);
+#ifdef GCL_TRACE
+#ifdef __CUDACC__
+            GT_CUDA_CHECK(cudaDeviceSynchronize());
+#endif
+            double end_time = MPI_Wtime();
+            stats_collector<DIMS>::instance()->add_event(
+                ExchangeEvent(ee_pack, start_time, end_time, sizeof...(FIELDS), pattern_tag));
+#endif
         }
 
         /**
@@ -337,7 +349,18 @@ namespace gridtools {
         */
         template <typename... FIELDS>
         void unpack(FIELDS *... _fields) {
+#ifdef GCL_TRACE
+            double start_time = MPI_Wtime();
+#endif
             hd.unpack(_fields...);
+#ifdef GCL_TRACE
+#ifdef __CUDACC__
+            GT_CUDA_CHECK(cudaDeviceSynchronize());
+#endif
+            double end_time = MPI_Wtime();
+            stats_collector<DIMS>::instance()->add_event(
+                ExchangeEvent(ee_unpack, start_time, end_time, sizeof...(FIELDS), pattern_tag));
+#endif
         }
 
         /**
@@ -457,6 +480,52 @@ namespace gridtools {
 #endif
         }
 
+        /**
+           function to complete a data exchange initiated with start_exchange() and unpack the received data. Where
+           the architecture allows it, the data from each neighbor is unpacked as soon as it arrives, hiding the
+           unpacking behind the latency of the messages still in flight. It replaces the wait() + unpack() sequence.
+
+           \param[in] _fields data fields where to unpack data
+        */
+        template <typename... FIELDS>
+        void wait_and_unpack(FIELDS *... _fields) {
+#ifdef GCL_TRACE
+            double start_time = MPI_Wtime();
+#endif
+            hd.wait_and_unpack(_fields...);
+#ifdef GCL_TRACE
+#ifdef __CUDACC__
+            GT_CUDA_CHECK(cudaDeviceSynchronize());
+#endif
+            double end_time = MPI_Wtime();
+            stats_collector<DIMS>::instance()->add_event(
+                ExchangeEvent(ee_unpack, start_time, end_time, sizeof...(FIELDS), pattern_tag));
+#endif
+        }
+
+        /**
+           function to complete a data exchange initiated with start_exchange() and unpack the received data as it
+           arrives. It replaces the wait() + unpack() sequence.
+
+           \param[in] fields vector with data fields pointers to be unpacked into
+        */
+        void wait_and_unpack(std::vector<DataType *> const &fields) {
+#ifdef GCL_TRACE
+            double start_time = MPI_Wtime();
+#endif
+            hd.wait_and_unpack(fields);
+#ifdef GCL_TRACE
+            double end_time = MPI_Wtime();
+            stats_collector<DIMS>::instance()->add_event(
+                ExchangeEvent(ee_unpack, start_time, end_time, fields.size(), pattern_tag));
+#endif
+        }
+
+        /**
+           Number of messages this process sends in one exchange
+        */
+        int message_count() const { return hd.message_count(); }
+
         grid_type const &comm() const { return hd.comm(); }
     };
 
@@ -548,6 +617,29 @@ namespace gridtools {
             hd.setup(max_fields_n, halo_example, typesize);
         }
 
+        /**
+           Function to setup internal data structures for data exchange, sizing the messages for exactly the fields
+           that will be exchanged together. The fields can have different halos and value types (but the same
+           layout), and are sent to each neighbor in a single message.
+
+           \param first, fields the fields that will be passed, in the same order, to the communication functions
+        */
+        template <typename DataType, typename layomap, template <typename> class _traits, typename... FIELDS>
+        void setup(field_on_the_fly<DataType, layomap, _traits> const &first, FIELDS const &... fields) {
+            hd.setup(first, fields...);
+        }
+
+        /**
+           Function to setup internal data structures for data exchange, sizing the messages for exactly the fields
+           in the vector, which can have different halos.
+
+           \param fields vector with the fields that will be passed to the communication functions
+        */
+        template <typename T1, typename T2, template <typename> class T3>
+        void setup(std::vector<field_on_the_fly<T1, T2, T3>> const &fields) {
+            hd.setup(fields);
+        }
+
         /**
            Function to pack data to be sent
 
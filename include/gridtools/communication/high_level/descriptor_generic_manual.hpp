@@ -55,6 +55,7 @@
 #include "../../common/make_array.hpp"
 #include "./helpers_impl.hpp"
 
+#include <initializer_list>
 #include <vector>
 
 namespace gridtools {
@@ -118,65 +119,49 @@ namespace gridtools {
         void setup(int max_fields_n,
             field_on_the_fly<DataType, f_layoutmap, traits> const &halo_example,
             int typesize = sizeof(DataType)) {
+            using field_t = field_on_the_fly<DataType, f_layoutmap, traits>;
+            allocate_buffers<typename field_t::inner_layoutmap>(
+                [&](gridtools::array<int, DIMS> const &eta, int &send_size, int &recv_size) {
+                    send_size = max_fields_n *
+                                field_t::template padded_size<char>(halo_example.send_buffer_size(eta) * typesize);
+                    recv_size = max_fields_n *
+                                field_t::template padded_size<char>(halo_example.recv_buffer_size(eta) * typesize);
+                });
+        }
 
-            typedef typename field_on_the_fly<DataType, f_layoutmap, traits>::inner_layoutmap t_layoutmap;
-            gridtools::array<int, DIMS> eta;
-            for (int i = -1; i <= 1; ++i) {
-                for (int j = -1; j <= 1; ++j) {
-                    for (int k = -1; k <= 1; ++k) {
-                        if (i != 0 || j != 0 || k != 0) {
-                            eta[0] = i;
-                            eta[1] = j;
-                            eta[2] = k;
-                            int S = 1;
-                            S = halo_example.send_buffer_size(eta);
-                            int R = 1;
-                            R = halo_example.recv_buffer_size(eta);
-
-                            send_buffer_size[translate()(i, j, k)] = (S * max_fields_n * typesize);
-                            recv_buffer_size[translate()(i, j, k)] = (R * max_fields_n * typesize);
-
-                            // std::cout << halo_example << std::endl;
-                            // std::cout << "Send size to "
-                            //           << i << ", "
-                            //           << j << ", "
-                            //           << k << ": "
-                            //           << send_buffer_size[translate()(i,j,k)]
-                            //           << std::endl;
-                            // std::cout << "Recv size fr "
-                            //           << i << ", "
-                            //           << j << ", "
-                            //           << k << ": "
-                            //           << recv_buffer_size[translate()(i,j,k)]
-                            //           << std::endl;
-                            // std::cout << std::endl;
-                            // std::cout.flush();
-
-                            send_buffer[translate()(i, j, k)] =
-                                _impl::gcl_alloc<char, arch_type>::alloc(send_buffer_size[translate()(i, j, k)]);
-                            recv_buffer[translate()(i, j, k)] =
-                                _impl::gcl_alloc<char, arch_type>::alloc(recv_buffer_size[translate()(i, j, k)]);
-
-                            typedef typename layout_transform<t_layoutmap, proc_layout_abs>::type proc_layout;
-                            const int i_P = make_array(i, j, k)[proc_layout::at(0)];
-                            const int j_P = make_array(i, j, k)[proc_layout::at(1)];
-                            const int k_P = make_array(i, j, k)[proc_layout::at(2)];
-
-                            base_type::m_haloexch.register_send_to_buffer(&(send_buffer[translate()(i, j, k)][0]),
-                                send_buffer_size[translate()(i, j, k)],
-                                i_P,
-                                j_P,
-                                k_P);
-
-                            base_type::m_haloexch.register_receive_from_buffer(&(recv_buffer[translate()(i, j, k)][0]),
-                                recv_buffer_size[translate()(i, j, k)],
-                                i_P,
-                                j_P,
-                                k_P);
-                        }
-                    }
-                }
-            }
+        /**
+           Setup function that sizes the buffers for exactly the fields passed as arguments, which can have
+           different halos and value types. The data of all of them is sent to each neighbor in a single message,
+           and no more bytes than needed are sent when the same fields are exchanged.
+
+           \param[in] first, fields The fields that are going to be exchanged together, in the same order
+         */
+        template <typename DataType, typename f_layoutmap, template <typename> class traits, typename... FIELDS>
+        void setup(field_on_the_fly<DataType, f_layoutmap, traits> const &first, FIELDS const &... fields) {
+            allocate_buffers<typename field_on_the_fly<DataType, f_layoutmap, traits>::inner_layoutmap>(
+                [&](gridtools::array<int, DIMS> const &eta, int &send_size, int &recv_size) {
+                    send_size = 0;
+                    recv_size = 0;
+                    add_message_size(eta, first, send_size, recv_size);
+                    (void)std::initializer_list<int>{(add_message_size(eta, fields, send_size, recv_size), 0)...};
+                });
+        }
+
+        /**
+           Setup function that sizes the buffers for exactly the fields in the vector, which can have different
+           halos.
+
+           \param[in] fields vector with the fields that are going to be exchanged together, in the same order
+         */
+        template <typename T1, typename T2, template <typename> class T3>
+        void setup(std::vector<field_on_the_fly<T1, T2, T3>> const &fields) {
+            allocate_buffers<typename field_on_the_fly<T1, T2, T3>::inner_layoutmap>(
+                [&](gridtools::array<int, DIMS> const &eta, int &send_size, int &recv_size) {
+                    send_size = 0;
+                    recv_size = 0;
+                    for (auto const &field : fields)
+                        add_message_size(eta, field, send_size, recv_size);
+                });
         }
 
         /**
@@ -190,37 +175,10 @@ namespace gridtools {
          */
         template <typename DataType, typename t_layoutmap>
         void setup(gridtools::array<size_t, _impl::static_pow3<DIMS>::value> const &buffer_size_list) {
-            for (int i = -1; i <= 1; ++i) {
-                for (int j = -1; j <= 1; ++j) {
-                    for (int k = -1; k <= 1; ++k) {
-                        if (i != 0 || j != 0 || k != 0) {
-                            send_buffer[translate()(i, j, k)] =
-                                _impl::gcl_alloc<char, arch_type>::alloc(buffer_size_list[translate()(i, j, k)]);
-                            recv_buffer[translate()(i, j, k)] =
-                                _impl::gcl_alloc<char, arch_type>::alloc(buffer_size_list[translate()(i, j, k)]);
-                            send_buffer_size[translate()(i, j, k)] = (buffer_size_list[translate()(i, j, k)]);
-                            recv_buffer_size[translate()(i, j, k)] = (buffer_size_list[translate()(i, j, k)]);
-
-                            typedef typename layout_transform<t_layoutmap, proc_layout_abs>::type proc_layout;
-                            const int i_P = make_array(i, j, k)[proc_layout::at(0)];
-                            const int j_P = make_array(i, j, k)[proc_layout::at(1)];
-                            const int k_P = make_array(i, j, k)[proc_layout::at(2)];
-
-                            base_type::m_haloexch.register_send_to_buffer(&(send_buffer[translate()(i, j, k)][0]),
-                                buffer_size_list[translate()(i, j, k)],
-                                i_P,
-                                j_P,
-                                k_P);
-
-                            base_type::m_haloexch.register_receive_from_buffer(&(recv_buffer[translate()(i, j, k)][0]),
-                                buffer_size_list[translate()(i, j, k)],
-                                i_P,
-                                j_P,
-                                k_P);
-                        }
-                    }
-                }
-            }
+            allocate_buffers<t_layoutmap>([&](gridtools::array<int, DIMS> const &eta, int &send_size, int &recv_size) {
+                send_size = buffer_size_list[translate()(eta[0], eta[1], eta[2])];
+                recv_size = send_size;
+            });
         }
 
         template <typename... FIELDS>
@@ -288,6 +246,40 @@ namespace gridtools {
         }
 
       private:
+        /*
+          Allocates and registers with the pattern the buffers for all the neighbors. `sizes(eta, send_size,
+          recv_size)` gives the sizes in bytes of the messages to and from the neighbor eta.
+        */
+        template <typename t_layoutmap, typename F>
+        void allocate_buffers(F const &sizes) {
+            typedef typename layout_transform<t_layoutmap, proc_layout_abs>::type proc_layout;
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        if (i == 0 && j == 0 && k == 0)
+                            continue;
+                        const int idx = translate()(i, j, k);
+                        sizes(make_array(i, j, k), send_buffer_size[idx], recv_buffer_size[idx]);
+                        send_buffer[idx] = _impl::gcl_alloc<char, arch_type>::alloc(send_buffer_size[idx]);
+                        recv_buffer[idx] = _impl::gcl_alloc<char, arch_type>::alloc(recv_buffer_size[idx]);
+
+                        const int i_P = make_array(i, j, k)[proc_layout::at(0)];
+                        const int j_P = make_array(i, j, k)[proc_layout::at(1)];
+                        const int k_P = make_array(i, j, k)[proc_layout::at(2)];
+                        base_type::m_haloexch.register_send_to_buffer(
+                            &(send_buffer[idx][0]), send_buffer_size[idx], i_P, j_P, k_P);
+                        base_type::m_haloexch.register_receive_from_buffer(
+                            &(recv_buffer[idx][0]), recv_buffer_size[idx], i_P, j_P, k_P);
+                    }
+        }
+
+        template <typename Field>
+        static void add_message_size(
+            gridtools::array<int, DIMS> const &eta, Field const &field, int &send_size, int &recv_size) {
+            send_size += Field::template padded_size<typename Field::value_type>(field.send_buffer_size(eta));
+            recv_size += Field::template padded_size<typename Field::value_type>(field.recv_buffer_size(eta));
+        }
+
         template <int, int>
         struct pack_dims {};
 
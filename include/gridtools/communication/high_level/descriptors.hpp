@@ -9,6 +9,10 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+
 #include "../../common/array.hpp"
 #include "../../common/make_array.hpp"
 #include "../low_level/Halo_Exchange_3D.hpp"
@@ -61,74 +65,139 @@ namespace gridtools {
 
         const halo_descriptor *raw_array() const { return &(base_type::halos[0]); }
 
+        /// box of the field that is sent to or received from a neighbor
+        struct region {
+            gridtools::array<int, 3> low;
+            gridtools::array<int, 3> size;
+
+            int rows() const { return size[1] * size[2]; }
+            int elements() const { return size[0] * rows(); }
+        };
+
+        /// box sent to the neighbor `eta`
+        region inside(gridtools::array<int, 3> const &eta) const {
+            region res;
+            for (int d = 0; d < 3; ++d) {
+                res.low[d] = halos[d].loop_low_bound_inside(eta[d]);
+                res.size[d] = std::max(0, halos[d].loop_high_bound_inside(eta[d]) - res.low[d] + 1);
+            }
+            return res;
+        }
+
+        /// box received from the neighbor `eta`
+        region outside(gridtools::array<int, 3> const &eta) const {
+            region res;
+            for (int d = 0; d < 3; ++d) {
+                res.low[d] = halos[d].loop_low_bound_outside(eta[d]);
+                res.size[d] = std::max(0, halos[d].loop_high_bound_outside(eta[d]) - res.low[d] + 1);
+            }
+            return res;
+        }
+
+      private:
+        int row_offset(region const &r, int row) const {
+            return gridtools::access(r.low[0],
+                r.low[1] + row % r.size[1],
+                r.low[2] + row / r.size[1],
+                halos[0].total_length(),
+                halos[1].total_length(),
+                halos[2].total_length());
+        }
+
+      public:
+        /**
+            Bytes taken in a message buffer by `elements` values of type T. The data of each field starts at an
+            address aligned for any type, so that fields of different value types can share a buffer.
+        */
+        template <typename T>
+        static int padded_size(int elements) {
+            constexpr int align = alignof(std::max_align_t);
+            return (elements * int(sizeof(T)) + align - 1) / align * align;
+        }
+
+        /**
+            Packs the data of the field to be sent to the neighbor `eta` into the buffer pointed to by `it` and
+            advances `it` past the packed data, rounded up as by `padded_size`. The rows along the first dimension have
+            unit stride in the field and in the buffer and are copied as contiguous runs.
+        */
         template <typename iterator_in, typename iterator_out>
         void pack(gridtools::array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
-            // std::cout << "BASE ADDR IN PACK " << std::hex << reinterpret_cast<void*>(it) << std::dec << std::endl;
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_inside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_inside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_inside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_inside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_inside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_inside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_inside(eta[0]); i <= halos[0].loop_high_bound_inside(eta[0]);
-                         ++i) {
-
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << field_ptr[gridtools::access
-                        //                        (i,j,k,
-                        //                         base_type::halos[0].total_length(),
-                        //                         base_type::halos[1].total_length(),
-                        //                         base_type::halos[2].total_length())]
-                        //           << std::endl;
-
-                        *(reinterpret_cast<iterator_in *>(it)) = field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())];
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            region r = inside(eta);
+            iterator_in *buffer = reinterpret_cast<iterator_in *>(it);
+            for (int row = 0; row < r.rows(); ++row)
+                std::copy_n(field_ptr + row_offset(r, row), r.size[0], buffer + row * r.size[0]);
+            it = reinterpret_cast<iterator_out *>(
+                reinterpret_cast<char *>(it) + padded_size<iterator_in>(r.elements()));
         }
 
+        /**
+            Unpacks the data received from the neighbor `eta` from the buffer pointed to by `it` into the field and
+            advances `it` past the unpacked data, rounded up as by `padded_size`.
+        */
         template <typename iterator_in, typename iterator_out>
         void unpack(gridtools::array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
-            // std::cout << "k=" << base_type::halos[2].loop_low_bound_outside(eta[2])
-            //           << " to <= " << base_type::halos[2].loop_high_bound_outside(eta[2]) << ",\n"
-            //           << "j=" << base_type::halos[1].loop_low_bound_outside(eta[1])
-            //           << " to <= " << base_type::halos[1].loop_high_bound_outside(eta[1]) << ",\n"
-            //           << "i=" << base_type::halos[0].loop_low_bound_outside(eta[0])
-            //           << " to <= " << base_type::halos[0].loop_high_bound_outside(eta[0])
-            //           << std::endl;
-            for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]); ++k) {
-                for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
-                     ++j) {
-                    for (int i = halos[0].loop_low_bound_outside(eta[0]); i <= halos[0].loop_high_bound_outside(eta[0]);
-                         ++i) {
-                        // std::cout << "      "
-                        //           << i << ", "
-                        //           << j << ", "
-                        //           << k << ", "
-                        //           << base_type::halos[0].total_length() << ", "
-                        //           << base_type::halos[1].total_length() << ", "
-                        //           << base_type::halos[2].total_length() << ", "
-                        //           << *(reinterpret_cast<iterator_in*>(it))
-                        //           << std::endl;
-                        field_ptr[gridtools::access(
-                            i, j, k, halos[0].total_length(), halos[1].total_length(), halos[2].total_length())] =
-                            *(reinterpret_cast<iterator_in *>(it));
-                        reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                    }
-                }
-            }
+            region r = outside(eta);
+            iterator_in const *buffer = reinterpret_cast<iterator_in const *>(it);
+            for (int row = 0; row < r.rows(); ++row)
+                std::copy_n(buffer + row * r.size[0], r.size[0], field_ptr + row_offset(r, row));
+            it = reinterpret_cast<iterator_out *>(
+                reinterpret_cast<char *>(it) + padded_size<iterator_in>(r.elements()));
+        }
+
+        /**
+            Like `pack`, but the rows are shared among the threads of the enclosing OpenMP parallel region, without a
+            barrier at the end. All threads of the region have to call it with the same arguments.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void pack_shared(gridtools::array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
+            pack_shared(inside(eta), field_ptr, it);
+        }
+
+        /**
+            Like `pack_shared`, but for an arbitrary box of the field.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void pack_shared(region const &r, iterator_in const *field_ptr, iterator_out *&it) const {
+            iterator_in *buffer = reinterpret_cast<iterator_in *>(it);
+#pragma omp for nowait
+            for (int row = 0; row < r.rows(); ++row)
+                std::copy_n(field_ptr + row_offset(r, row), r.size[0], buffer + row * r.size[0]);
+            it = reinterpret_cast<iterator_out *>(reinterpret_cast<char *>(it) + r.elements() * sizeof(iterator_in));
+        }
+
+        /**
+            Like `unpack`, but the rows are shared among the threads of the enclosing OpenMP parallel region, without
+            a barrier at the end. All threads of the region have to call it with the same arguments.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void unpack_shared(gridtools::array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
+            unpack_shared(outside(eta), field_ptr, it);
+        }
+
+        /**
+            Like `unpack_shared`, but for an arbitrary box of the field.
+        */
+        template <typename iterator_in, typename iterator_out>
+        void unpack_shared(region const &r, iterator_in *field_ptr, iterator_out *&it) const {
+            iterator_in const *buffer = reinterpret_cast<iterator_in const *>(it);
+#pragma omp for nowait
+            for (int row = 0; row < r.rows(); ++row)
+                std::copy_n(buffer + row * r.size[0], r.size[0], field_ptr + row_offset(r, row));
+            it = reinterpret_cast<iterator_out *>(reinterpret_cast<char *>(it) + r.elements() * sizeof(iterator_in));
+        }
+
+        /**
+            Copies the box sent to the neighbor `-eta` into the box received from the neighbor `eta` of the same field,
+            which is the whole exchange with a neighbor that is the process itself. The rows are shared among the
+            threads of the enclosing OpenMP parallel region as in `unpack_shared`.
+        */
+        template <typename iterator_in>
+        void copy_shared(gridtools::array<int, 3> const &eta, iterator_in *field_ptr) const {
+            region src = inside(make_array(-eta[0], -eta[1], -eta[2]));
+            region dst = outside(eta);
+#pragma omp for nowait
+            for (int row = 0; row < src.rows(); ++row)
+                std::copy_n(field_ptr + row_offset(src, row), src.size[0], field_ptr + row_offset(dst, row));
         }
 
         template <typename iterator>
@@ -426,6 +495,55 @@ namespace gridtools {
         array<int, _impl::static_pow3<DIMS>::value> send_size;
         array<int, _impl::static_pow3<DIMS>::value> recv_size;
 
+        halo_exchange_mode m_mode = halo_exchange_mode::all_neighbors;
+        // buffers of the by_dimension mode, indexed by 2 * dimension + (side > 0)
+        array<std::vector<DataType>, 6> m_face_send_buffer;
+        array<std::vector<DataType>, 6> m_face_recv_buffer;
+        // the messages of the dimension in flight
+        std::vector<MPI_Request> m_face_requests;
+
+        // shared_memory mode: where the messages to and from the neighbors on the same node are packed and unpacked
+        // (nullptr for off-node neighbors). The buffers of two consecutive exchanges alternate, so that a process
+        // packing the next exchange never overwrites data a neighbor is still unpacking.
+        array<array<DataType *, _impl::static_pow3<DIMS>::value>, 2> m_node_send{};
+        array<array<DataType *, _impl::static_pow3<DIMS>::value>, 2> m_node_recv{};
+        int m_parity = 0;
+        MPI_Comm m_node_comm = MPI_COMM_NULL;
+        // the ranks in m_node_comm of the neighbors on the node, once per direction, and the notifications exchanged
+        // with them in sync_node
+        std::vector<int> m_node_neighbors;
+        std::vector<MPI_Request> m_node_requests;
+
+        // the neighbors that are this process itself, along the periodic dimensions with a single process: their
+        // halos are copied within the fields, without MPI messages, in unpack or, in the derived_datatypes mode, when
+        // the exchange starts. The by_dimension mode copies through its face buffers.
+        array<bool, _impl::static_pow3<DIMS>::value> m_self{};
+        MPI_Win m_node_window = MPI_WIN_NULL;
+
+        // derived_datatypes mode: subarray types of the boxes sent to and received from each neighbor, built in
+        // setup, and the types of the messages, which combine them over the fields of the last exchange
+        array<std::pair<MPI_Datatype, bool>, _impl::static_pow3<DIMS>::value> m_send_types{};
+        array<std::pair<MPI_Datatype, bool>, _impl::static_pow3<DIMS>::value> m_recv_types{};
+        array<MPI_Datatype, _impl::static_pow3<DIMS>::value> m_message_send_types;
+        array<MPI_Datatype, _impl::static_pow3<DIMS>::value> m_message_recv_types;
+        // the fields passed to pack, in the derived_datatypes and by_dimension modes
+        std::vector<DataType *> m_fields;
+        std::vector<DataType *> m_typed_fields;
+        std::vector<MPI_Request> m_requests;
+
+        // neighbor_collective mode: the graph communicator, the buffers of its outgoing and incoming edges, and the
+        // arguments of the collective in flight
+        MPI_Comm m_graph_comm = MPI_COMM_NULL;
+        std::vector<int> m_graph_send_idx;
+        std::vector<int> m_graph_recv_idx;
+        std::vector<int> m_graph_send_counts;
+        std::vector<int> m_graph_recv_counts;
+        std::vector<MPI_Aint> m_graph_send_displs;
+        std::vector<MPI_Aint> m_graph_recv_displs;
+        std::vector<MPI_Datatype> m_graph_types;
+        MPI_Request m_graph_request = MPI_REQUEST_NULL;
+        int m_packed_fields = 0;
+
       public:
         typedef gcl_cpu arch_type;
         typedef descriptor_base<HaloExch> base_type;
@@ -461,6 +579,9 @@ namespace gridtools {
 #endif
 
             _destroy_dynamic_ut<DIMS, 0>().do_it(this);
+            free_node_window();
+            free_datatypes();
+            free_graph();
         }
 
         /**
@@ -484,11 +605,119 @@ namespace gridtools {
         }
 
         /**
-           Function to setup internal data structures for data exchange and preparing eventual underlying layers
+           Function to setup internal data structures for data exchange and preparing eventual underlying layers.
+           In the all_neighbors and shared_memory modes the messages are set up once as persistent requests for
+           `max_fields_n` fields. In the shared_memory mode this function, as well as the destructor, is collective
+           over the processes of each node.
 
            \param max_fields_n Maximum number of data fields that will be passed to the communication functions
+           \param mode How the halos are exchanged, see halo_exchange_mode
+        */
+        void setup(int max_fields_n, halo_exchange_mode mode = halo_exchange_mode::all_neighbors) {
+            m_mode = mode;
+            find_self_neighbors();
+            if (m_mode == halo_exchange_mode::by_dimension) {
+                for (int d = 0; d < 3; ++d)
+                    for (int side = -1; side <= 1; side += 2) {
+                        int i = face_index(d, side);
+                        m_face_send_buffer[i].resize(face_region(d, side, false).elements() * max_fields_n);
+                        m_face_recv_buffer[i].resize(face_region(d, side, true).elements() * max_fields_n);
+                    }
+                return;
+            }
+            if (m_mode == halo_exchange_mode::derived_datatypes) {
+                std::fill(m_message_send_types.begin(), m_message_send_types.end(), MPI_DATATYPE_NULL);
+                std::fill(m_message_recv_types.begin(), m_message_recv_types.end(), MPI_DATATYPE_NULL);
+                for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (m_self[idx])
+                        return;
+                    m_send_types[idx] = _impl::make_datatype_outin<DataType>::inside(halo.halos, eta);
+                    m_recv_types[idx] = _impl::make_datatype_outin<DataType>::outside(halo.halos, eta);
+                });
+                return;
+            }
+            _impl::allocation_service<this_type>()(this, max_fields_n);
+            if (m_mode == halo_exchange_mode::neighbor_collective) {
+                setup_graph();
+                return;
+            }
+            if (m_mode == halo_exchange_mode::shared_memory)
+                setup_node_window(max_fields_n);
+            // no MPI messages to the neighbors on the node and to this process itself
+            set_message_sizes(*this, max_fields_n);
+            base_type::m_haloexch.enable_persistent_requests();
+        }
+
+        /**
+           Number of MPI messages this process sends in one exchange, given the neighbors it has in the processor grid
+        */
+        int message_count() const {
+            int res = 0;
+            if (m_mode == halo_exchange_mode::by_dimension) {
+                for (int d = 0; d < 3; ++d)
+                    for (int side = -1; side <= 1; side += 2)
+                        if (neighbor(face(d, side)) != -1 && !self_face(d, side) &&
+                            face_region(d, side, false).elements() > 0)
+                            ++res;
+            } else {
+                for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if ((send_size[idx] > 0 && !on_node(idx) && !m_self[idx]) || m_send_types[idx].second)
+                        ++res;
+                });
+            }
+            return res;
+        }
+
+        /*
+          In the by_dimension mode every step sends data received in the previous one: pack packs the first
+          dimension, start_exchange (or do_sends) sends it, and wait receives it and forwards the halos along the other
+          dimensions, so that only the first dimension overlaps with the work done between start_exchange and wait.
+          As in the derived_datatypes mode the halos are written into the fields passed to pack, and unpack does
+          nothing.
+          In the shared_memory mode every process synchronizes once per exchange with its neighbors on the node, in
+          exchange() or wait().
+          In the derived_datatypes mode the halos are received directly into the fields passed to pack, so the
+          receives can only be posted together with the sends, and unpack does nothing. The neighbor_collective mode
+          too posts the receives and the sends at once, in a single collective.
         */
-        void setup(int max_fields_n) { _impl::allocation_service<this_type>()(this, max_fields_n); }
+        void exchange() {
+            if (uses_pattern())
+                base_type::exchange();
+            else {
+                start_mode_exchange();
+                wait_mode_exchange();
+            }
+            sync_node();
+        }
+
+        void post_receives() {
+            if (uses_pattern())
+                base_type::post_receives();
+        }
+
+        void do_sends() {
+            if (uses_pattern())
+                base_type::do_sends();
+            else
+                start_mode_exchange();
+        }
+
+        void start_exchange() {
+            if (uses_pattern())
+                base_type::start_exchange();
+            else
+                start_mode_exchange();
+        }
+
+        void wait() {
+            if (uses_pattern())
+                base_type::wait();
+            else
+                wait_mode_exchange();
+            sync_node();
+        }
 
 #ifdef GCL_TRACE
         void set_pattern_tag(int tag) { base_type::m_haloexch.set_pattern_tag(tag); };
@@ -501,7 +730,13 @@ namespace gridtools {
         */
         template <typename... FIELDS>
         void pack(const FIELDS &... _fields) {
-            pack_dims<DIMS, 0>()(*this, _fields...);
+            if (m_mode == halo_exchange_mode::derived_datatypes)
+                m_fields = {field_address(_fields)...};
+            else if (m_mode == halo_exchange_mode::by_dimension) {
+                m_fields = {field_address(_fields)...};
+                pack_first_faces();
+            } else
+                pack_dims<DIMS, 0>()(*this, _fields...);
         }
 
         /**
@@ -510,8 +745,9 @@ namespace gridtools {
            \param[in] _fields data fields where to unpack data
         */
         template <typename... FIELDS>
-        void unpack(const FIELDS &... _fields) const {
-            unpack_dims<DIMS, 0>()(*this, _fields...);
+        void unpack(const FIELDS &... _fields) {
+            if (uses_pattern() || m_mode == halo_exchange_mode::neighbor_collective)
+                unpack_dims<DIMS, 0>()(*this, _fields...);
         }
 
         /**
@@ -519,14 +755,68 @@ namespace gridtools {
 
            \param[in] fields vector with data fields pointers to be packed from
         */
-        void pack(std::vector<DataType *> const &fields) { pack_vector_dims<DIMS, 0>()(*this, fields); }
+        void pack(std::vector<DataType *> const &fields) {
+            if (m_mode == halo_exchange_mode::derived_datatypes)
+                m_fields = fields;
+            else if (m_mode == halo_exchange_mode::by_dimension) {
+                m_fields = fields;
+                pack_first_faces();
+            } else
+                pack_vector_dims<DIMS, 0>()(*this, fields);
+        }
 
         /**
            Function to unpack received data
 
            \param[in] fields vector with data fields pointers to be unpacked into
         */
-        void unpack(std::vector<DataType *> const &fields) { unpack_vector_dims<DIMS, 0>()(*this, fields); }
+        void unpack(std::vector<DataType *> const &fields) {
+            if (uses_pattern() || m_mode == halo_exchange_mode::neighbor_collective)
+                unpack_vector_dims<DIMS, 0>()(*this, fields);
+        }
+
+        /**
+           Function to complete an exchange started with start_exchange(), unpacking the data received from each
+           neighbor as soon as it arrives instead of waiting for all the messages first
+
+           \param[in] _fields data fields where to unpack data
+        */
+        template <typename... FIELDS>
+        void wait_and_unpack(const FIELDS &... _fields) {
+            if (!uses_pattern()) {
+                wait();
+                return unpack(_fields...);
+            }
+            wait_and_unpack_impl(
+                [&](gridtools::array<int, 3> const &eta, DataType *it) {
+                    (void)std::initializer_list<int>{(halo.unpack_shared(eta, _fields, it), 0)...};
+                },
+                [&](gridtools::array<int, 3> const &eta) {
+                    (void)std::initializer_list<int>{(halo.copy_shared(eta, _fields), 0)...};
+                });
+        }
+
+        /**
+           Function to complete an exchange started with start_exchange(), unpacking the data received from each
+           neighbor as soon as it arrives instead of waiting for all the messages first
+
+           \param[in] fields vector with data fields pointers to be unpacked into
+        */
+        void wait_and_unpack(std::vector<DataType *> const &fields) {
+            if (!uses_pattern()) {
+                wait();
+                return unpack(fields);
+            }
+            wait_and_unpack_impl(
+                [&](gridtools::array<int, 3> const &eta, DataType *it) {
+                    for (size_t i = 0; i < fields.size(); ++i)
+                        halo.unpack_shared(eta, fields[i], it);
+                },
+                [&](gridtools::array<int, 3> const &eta) {
+                    for (size_t i = 0; i < fields.size(); ++i)
+                        halo.copy_shared(eta, fields[i]);
+                });
+        }
 
         /// Utilities
 
@@ -547,6 +837,541 @@ namespace gridtools {
         // friend class _impl::unpack_service<this_type>;
 
       private:
+        // calls `f(eta, ii_P, jj_P, kk_P)` for all the neighbors that exist in the processor grid
+        template <typename T, typename F>
+        static void for_each_neighbor(T &hm, F const &f) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                for (int jj = -1; jj <= 1; ++jj) {
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        typedef proc_layout map_type;
+                        const int ii_P = make_array(ii, jj, kk)[map_type::at(0)];
+                        const int jj_P = make_array(ii, jj, kk)[map_type::at(1)];
+                        const int kk_P = make_array(ii, jj, kk)[map_type::at(2)];
+                        if ((ii != 0 || jj != 0 || kk != 0) && (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1))
+                            f(make_array(ii, jj, kk), ii_P, jj_P, kk_P);
+                    }
+                }
+            }
+        }
+
+        typedef empty_field_no_dt::region region;
+
+        static int face_index(int d, int side) { return 2 * d + (side > 0); }
+
+        // tags of the by_dimension messages, distinct from those used by the pattern
+        static int face_tag(int d, int side) { return 27 + face_index(d, side); }
+
+        static gridtools::array<int, 3> face(int d, int side) {
+            gridtools::array<int, 3> eta = {0, 0, 0};
+            eta[d] = side;
+            return eta;
+        }
+
+        int neighbor(gridtools::array<int, 3> const &eta) const {
+            typedef proc_layout map_type;
+            return base_type::pattern().proc_grid().proc(
+                eta[map_type::at(0)], eta[map_type::at(1)], eta[map_type::at(2)]);
+        }
+
+        /*
+          Box exchanged with the face neighbor along dimension `d` in the by_dimension mode: along the dimensions
+          exchanged before `d` it extends over the halos that have been received already.
+        */
+        region face_region(int d, int side, bool receive) const {
+            region res = receive ? halo.outside(face(d, side)) : halo.inside(face(d, side));
+            for (int e = 0; e < d; ++e) {
+                halo_descriptor const &h = halo.raw_array()[e];
+                int low = neighbor(face(e, -1)) != -1 ? h.loop_low_bound_outside(-1) : h.loop_low_bound_inside(0);
+                int high = neighbor(face(e, 1)) != -1 ? h.loop_high_bound_outside(1) : h.loop_high_bound_inside(0);
+                res.low[e] = low;
+                res.size[e] = std::max(0, high - low + 1);
+            }
+            return res;
+        }
+
+        /*
+          The face neighbor along dimension `d` on the side `2 * s - 1` in the by_dimension mode, -1 if there is
+          nothing to exchange with it.
+        */
+        int face_neighbor(int d, int s) const {
+            const int side = 2 * s - 1;
+            if (face_region(d, side, false).elements() == 0 && face_region(d, side, true).elements() == 0)
+                return -1;
+            return neighbor(face(d, side));
+        }
+
+        bool face_active(int d) const { return face_neighbor(d, 0) != -1 || face_neighbor(d, 1) != -1; }
+
+        // the first dimension with something to exchange in the by_dimension mode, 3 if there is none
+        int first_face_dim() const {
+            int d = 0;
+            while (d < 3 && !face_active(d))
+                ++d;
+            return d;
+        }
+
+        /*
+          Packs (receive false) or unpacks (receive true) the fields passed to pack for the face neighbors along
+          dimension `d`. Called by all the threads of a parallel region. A face whose neighbor is this process itself
+          is not sent: the halo on the opposite side is unpacked directly from its send buffer.
+        */
+        void pack_or_unpack_faces(int d, bool receive) {
+            for (int s = 0; s < 2; ++s) {
+                const int side = 2 * s - 1;
+                if (face_neighbor(d, s) == -1)
+                    continue;
+                region r = face_region(d, side, receive);
+                DataType *it = !receive ? m_face_send_buffer[face_index(d, side)].data()
+                               : self_face(d, side) ? m_face_send_buffer[face_index(d, -side)].data()
+                                                    : m_face_recv_buffer[face_index(d, side)].data();
+                for (size_t i = 0; i < m_fields.size(); ++i)
+                    if (receive)
+                        halo.unpack_shared(r, m_fields[i], it);
+                    else
+                        halo.pack_shared(r, m_fields[i], it);
+            }
+        }
+
+        void pack_first_faces() {
+            const int d = first_face_dim();
+            if (d < 3) {
+#pragma omp parallel
+                pack_or_unpack_faces(d, false);
+            }
+        }
+
+        // posts the messages of the by_dimension mode along dimension `d`, the faces have to be packed already
+        void start_faces(int d) {
+            MPI_Comm comm = get_communicator(base_type::pattern().proc_grid());
+            m_face_requests.clear();
+            for (int s = 0; s < 2; ++s) {
+                const int side = 2 * s - 1;
+                const int proc = face_neighbor(d, s);
+                if (proc == -1 || self_face(d, side))
+                    continue;
+                m_face_requests.emplace_back();
+                MPI_Irecv(m_face_recv_buffer[face_index(d, side)].data(),
+                    face_region(d, side, true).elements() * m_fields.size() * sizeof(DataType),
+                    MPI_CHAR,
+                    proc,
+                    face_tag(d, -side),
+                    comm,
+                    &m_face_requests.back());
+            }
+            for (int s = 0; s < 2; ++s) {
+                const int side = 2 * s - 1;
+                const int proc = face_neighbor(d, s);
+                if (proc == -1 || self_face(d, side))
+                    continue;
+                m_face_requests.emplace_back();
+                MPI_Isend(m_face_send_buffer[face_index(d, side)].data(),
+                    face_region(d, side, false).elements() * m_fields.size() * sizeof(DataType),
+                    MPI_CHAR,
+                    proc,
+                    face_tag(d, side),
+                    comm,
+                    &m_face_requests.back());
+            }
+        }
+
+        void start_face_exchange() {
+            const int d = first_face_dim();
+            if (d < 3)
+                start_faces(d);
+        }
+
+        /*
+          Completes the by_dimension exchange whose first dimension has been sent by start_face_exchange: the halos
+          of each dimension are unpacked, then the next dimension, which forwards them, is packed and sent. All of it
+          runs in a single parallel region: the master thread does the communication and the threads meet at a
+          barrier between the phases.
+        */
+        void wait_face_exchange() {
+            const int first = first_face_dim();
+#pragma omp parallel
+            for (int d = first; d < 3; ++d) {
+                if (!face_active(d))
+                    continue;
+                if (d != first) {
+                    pack_or_unpack_faces(d, false);
+#pragma omp barrier
+#pragma omp master
+                    start_faces(d);
+                }
+#pragma omp master
+                {
+                    MPI_Waitall(m_face_requests.size(), m_face_requests.data(), MPI_STATUSES_IGNORE);
+                    m_face_requests.clear();
+                }
+#pragma omp barrier
+                pack_or_unpack_faces(d, true);
+                // the next dimension sends the halos just received
+#pragma omp barrier
+            }
+        }
+
+        /*
+          The rows of every message are unpacked by all threads while the next messages may still be in flight. The
+          halos of the neighbors that are this process itself are copied first, by `copy_self(eta)`.
+        */
+        template <typename F, typename G>
+        void wait_and_unpack_impl(F const &unpack_message, G const &copy_self) {
+#pragma omp parallel
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                if (m_self[translate()(eta[0], eta[1], eta[2])])
+                    copy_self(eta);
+            });
+            if (m_node_window != MPI_WIN_NULL) {
+                // the data from the same node is complete after the synchronization, the rest may still be in flight
+                sync_node();
+                for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (on_node(idx)) {
+#pragma omp parallel
+                        unpack_message(eta, recv_ptr(idx));
+                    }
+                });
+            }
+            base_type::m_haloexch.wait([&](int ii_P, int jj_P, int kk_P) {
+                typedef proc_layout map_type;
+                gridtools::array<int, 3> eta;
+                eta[map_type::at(0)] = ii_P;
+                eta[map_type::at(1)] = jj_P;
+                eta[map_type::at(2)] = kk_P;
+#pragma omp parallel
+                unpack_message(eta, recv_ptr(translate()(eta[0], eta[1], eta[2])));
+            });
+        }
+
+        bool on_node(int idx) const { return m_node_send[0][idx] != nullptr; }
+
+        bool self_face(int d, int side) const {
+            gridtools::array<int, 3> eta = face(d, side);
+            return m_self[translate()(eta[0], eta[1], eta[2])];
+        }
+
+        void find_self_neighbors() {
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int ii_P, int jj_P, int kk_P) {
+                m_self[translate()(eta[0], eta[1], eta[2])] =
+                    base_type::pattern().proc_grid().is_self(ii_P, jj_P, kk_P);
+            });
+        }
+
+        DataType *send_ptr(int idx) const { return on_node(idx) ? m_node_send[m_parity][idx] : send_buffer[idx]; }
+
+        DataType *recv_ptr(int idx) const { return on_node(idx) ? m_node_recv[1 - m_parity][idx] : recv_buffer[idx]; }
+
+        /*
+          Allocates the receive buffers for two consecutive exchanges in a shared memory window of the processes on
+          this node and points the buffers for the neighbors on the node directly into their windows. The segment of
+          every process starts with the offsets of its receive buffers and the size of the buffers of one exchange.
+        */
+        void setup_node_window(int max_fields_n) {
+            typedef proc_layout map_type;
+            const int n = _impl::static_pow3<DIMS>::value;
+            const std::size_t header_size =
+                ((n + 1) * sizeof(std::ptrdiff_t) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                alignof(std::max_align_t);
+
+            MPI_Comm comm = get_communicator(base_type::pattern().proc_grid());
+            int rank, node_size;
+            MPI_Comm_rank(comm, &rank);
+            MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_node_comm);
+            MPI_Comm_size(m_node_comm, &node_size);
+            if (node_size == 1) {
+                MPI_Comm_free(&m_node_comm);
+                return;
+            }
+
+            std::ptrdiff_t offsets[n + 1];
+            offsets[0] = 0;
+            for (int idx = 0; idx < n; ++idx)
+                offsets[idx + 1] = offsets[idx] + recv_size[idx] * max_fields_n;
+
+            char *segment;
+            MPI_Win_allocate_shared(header_size + 2 * offsets[n] * sizeof(DataType),
+                1,
+                MPI_INFO_NULL,
+                m_node_comm,
+                &segment,
+                &m_node_window);
+            std::copy_n(offsets, n + 1, reinterpret_cast<std::ptrdiff_t *>(segment));
+            MPI_Win_lock_all(MPI_MODE_NOCHECK, m_node_window);
+            MPI_Win_sync(m_node_window);
+            MPI_Barrier(m_node_comm);
+            MPI_Win_sync(m_node_window);
+
+            MPI_Group group, node_group;
+            MPI_Comm_group(comm, &group);
+            MPI_Comm_group(m_node_comm, &node_group);
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int ii_P, int jj_P, int kk_P) {
+                int proc = base_type::pattern().proc_grid().proc(ii_P, jj_P, kk_P);
+                int node_rank;
+                MPI_Group_translate_ranks(group, 1, &proc, node_group, &node_rank);
+                if (node_rank == MPI_UNDEFINED || m_self[translate()(eta[0], eta[1], eta[2])])
+                    return;
+                MPI_Aint size;
+                int disp_unit;
+                char *neighbor_segment;
+                MPI_Win_shared_query(m_node_window, node_rank, &size, &disp_unit, &neighbor_segment);
+                std::ptrdiff_t const *neighbor_offsets = reinterpret_cast<std::ptrdiff_t const *>(neighbor_segment);
+                DataType *neighbor_buffers = reinterpret_cast<DataType *>(neighbor_segment + header_size);
+                DataType *buffers = reinterpret_cast<DataType *>(segment + header_size);
+                // this process is the neighbor -eta of the receiving one
+                const int idx = translate()(eta[0], eta[1], eta[2]);
+                const int neighbor_idx = translate()(-eta[0], -eta[1], -eta[2]);
+                for (int p = 0; p < 2; ++p) {
+                    m_node_send[p][idx] = neighbor_buffers + p * neighbor_offsets[n] + neighbor_offsets[neighbor_idx];
+                    m_node_recv[p][idx] = buffers + p * offsets[n] + offsets[idx];
+                }
+                m_node_neighbors.push_back(node_rank);
+            });
+            m_node_requests.resize(2 * m_node_neighbors.size());
+            MPI_Group_free(&group);
+            MPI_Group_free(&node_group);
+        }
+
+        /*
+          Makes the data packed into the buffers of the neighbors on the node visible to them and switches to the
+          other buffers. Every process notifies each neighbor on the node, once per direction, and waits for the
+          notifications from them: a neighbor notifies only after it has packed this exchange, which it starts after
+          it has unpacked the previous one, so the buffers of this exchange are complete and those of the previous
+          one, which the next exchange overwrites, are no longer read. The relation is symmetric, so every
+          notification has its matching receive.
+        */
+        void sync_node() {
+            if (m_node_neighbors.empty())
+                return;
+            const int n = m_node_neighbors.size();
+            MPI_Win_sync(m_node_window);
+            for (int i = 0; i < n; ++i)
+                MPI_Irecv(nullptr, 0, MPI_BYTE, m_node_neighbors[i], 0, m_node_comm, &m_node_requests[i]);
+            for (int i = 0; i < n; ++i)
+                MPI_Isend(nullptr, 0, MPI_BYTE, m_node_neighbors[i], 0, m_node_comm, &m_node_requests[n + i]);
+            MPI_Waitall(2 * n, m_node_requests.data(), MPI_STATUSES_IGNORE);
+            MPI_Win_sync(m_node_window);
+            m_parity = 1 - m_parity;
+        }
+
+        // whether the messages are exchanged by the Halo_Exchange_3D pattern
+        bool uses_pattern() const {
+            return m_mode == halo_exchange_mode::all_neighbors || m_mode == halo_exchange_mode::shared_memory;
+        }
+
+        void start_mode_exchange() {
+            if (m_mode == halo_exchange_mode::by_dimension)
+                start_face_exchange();
+            else if (m_mode == halo_exchange_mode::derived_datatypes)
+                start_datatype_exchange();
+            else if (m_mode == halo_exchange_mode::neighbor_collective)
+                start_collective_exchange();
+        }
+
+        void wait_mode_exchange() {
+            if (m_mode == halo_exchange_mode::by_dimension)
+                wait_face_exchange();
+            else if (m_mode == halo_exchange_mode::derived_datatypes)
+                wait_datatype_exchange();
+            else if (m_mode == halo_exchange_mode::neighbor_collective)
+                MPI_Wait(&m_graph_request, MPI_STATUS_IGNORE);
+        }
+
+        /*
+          Creates a graph communicator with an edge to and from each neighbor, periodic ones included, except this
+          process itself, whose halos are copied in unpack. MPI matches the k-th edge from a process to another one
+          with the k-th edge to that one from the first: the data sent to the neighbor eta is received from the
+          neighbor -eta of the receiver, so the destinations are listed in some order of eta and the sources in the
+          same order of -eta.
+        */
+        void setup_graph() {
+            std::vector<int> sources, destinations;
+            for (int ii = -1; ii <= 1; ++ii)
+                for (int jj = -1; jj <= 1; ++jj)
+                    for (int kk = -1; kk <= 1; ++kk) {
+                        if (ii == 0 && jj == 0 && kk == 0)
+                            continue;
+                        const int destination = neighbor(make_array(ii, jj, kk));
+                        const int source = neighbor(make_array(-ii, -jj, -kk));
+                        if (destination != -1 && !m_self[translate()(ii, jj, kk)]) {
+                            destinations.push_back(destination);
+                            m_graph_send_idx.push_back(translate()(ii, jj, kk));
+                        }
+                        if (source != -1 && !m_self[translate()(-ii, -jj, -kk)]) {
+                            sources.push_back(source);
+                            m_graph_recv_idx.push_back(translate()(-ii, -jj, -kk));
+                        }
+                    }
+            MPI_Dist_graph_create_adjacent(get_communicator(base_type::pattern().proc_grid()),
+                sources.size(),
+                sources.data(),
+                MPI_UNWEIGHTED,
+                destinations.size(),
+                destinations.data(),
+                MPI_UNWEIGHTED,
+                MPI_INFO_NULL,
+                false,
+                &m_graph_comm);
+            m_graph_send_counts.resize(destinations.size());
+            m_graph_send_displs.resize(destinations.size());
+            m_graph_recv_counts.resize(sources.size());
+            m_graph_recv_displs.resize(sources.size());
+            m_graph_types.assign(std::max(sources.size(), destinations.size()), MPI_BYTE);
+        }
+
+        // the buffers are addressed through absolute displacements from MPI_BOTTOM
+        void start_collective_exchange() {
+            for (size_t i = 0; i < m_graph_send_idx.size(); ++i) {
+                const int idx = m_graph_send_idx[i];
+                m_graph_send_counts[i] = send_size[idx] * m_packed_fields * sizeof(DataType);
+                MPI_Get_address(send_buffer[idx], &m_graph_send_displs[i]);
+            }
+            for (size_t i = 0; i < m_graph_recv_idx.size(); ++i) {
+                const int idx = m_graph_recv_idx[i];
+                m_graph_recv_counts[i] = recv_size[idx] * m_packed_fields * sizeof(DataType);
+                MPI_Get_address(recv_buffer[idx], &m_graph_recv_displs[i]);
+            }
+            MPI_Ineighbor_alltoallw(MPI_BOTTOM,
+                m_graph_send_counts.data(),
+                m_graph_send_displs.data(),
+                m_graph_types.data(),
+                MPI_BOTTOM,
+                m_graph_recv_counts.data(),
+                m_graph_recv_displs.data(),
+                m_graph_types.data(),
+                m_graph_comm,
+                &m_graph_request);
+        }
+
+        void free_graph() {
+            int finalized;
+            MPI_Finalized(&finalized);
+            if (m_graph_comm != MPI_COMM_NULL && !finalized)
+                MPI_Comm_free(&m_graph_comm);
+        }
+
+        static DataType *field_address(DataType const *field) { return const_cast<DataType *>(field); }
+
+        // tags of the derived_datatypes messages, distinct from those used by the pattern and by_dimension
+        static int datatype_tag(gridtools::array<int, 3> const &eta) {
+            return 33 + translate()(eta[0], eta[1], eta[2]);
+        }
+
+        // builds the type of each message from the subarray types, with one block at the address of each field
+        void build_message_types() {
+            free_message_types();
+            std::vector<MPI_Aint> addresses(m_fields.size());
+            for (size_t i = 0; i < m_fields.size(); ++i)
+                MPI_Get_address(m_fields[i], &addresses[i]);
+            for (int idx = 0; idx < _impl::static_pow3<DIMS>::value; ++idx) {
+                if (m_send_types[idx].second) {
+                    MPI_Type_create_hindexed_block(
+                        m_fields.size(), 1, addresses.data(), m_send_types[idx].first, &m_message_send_types[idx]);
+                    MPI_Type_commit(&m_message_send_types[idx]);
+                }
+                if (m_recv_types[idx].second) {
+                    MPI_Type_create_hindexed_block(
+                        m_fields.size(), 1, addresses.data(), m_recv_types[idx].first, &m_message_recv_types[idx]);
+                    MPI_Type_commit(&m_message_recv_types[idx]);
+                }
+            }
+            m_typed_fields = m_fields;
+        }
+
+        void start_datatype_exchange() {
+            if (m_fields.empty())
+                return;
+            if (m_fields != m_typed_fields)
+                build_message_types();
+            MPI_Comm comm = get_communicator(base_type::pattern().proc_grid());
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int ii_P, int jj_P, int kk_P) {
+                const int idx = translate()(eta[0], eta[1], eta[2]);
+                if (m_recv_types[idx].second) {
+                    m_requests.emplace_back();
+                    MPI_Irecv(MPI_BOTTOM,
+                        1,
+                        m_message_recv_types[idx],
+                        base_type::pattern().proc_grid().proc(ii_P, jj_P, kk_P),
+                        datatype_tag(make_array(-eta[0], -eta[1], -eta[2])),
+                        comm,
+                        &m_requests.back());
+                }
+            });
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int ii_P, int jj_P, int kk_P) {
+                const int idx = translate()(eta[0], eta[1], eta[2]);
+                if (m_send_types[idx].second) {
+                    m_requests.emplace_back();
+                    MPI_Isend(MPI_BOTTOM,
+                        1,
+                        m_message_send_types[idx],
+                        base_type::pattern().proc_grid().proc(ii_P, jj_P, kk_P),
+                        datatype_tag(eta),
+                        comm,
+                        &m_requests.back());
+                }
+            });
+#pragma omp parallel
+            for_each_neighbor(*this, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                if (m_self[translate()(eta[0], eta[1], eta[2])])
+                    for (size_t i = 0; i < m_fields.size(); ++i)
+                        halo.copy_shared(eta, m_fields[i]);
+            });
+        }
+
+        void wait_datatype_exchange() {
+            MPI_Waitall(m_requests.size(), m_requests.data(), MPI_STATUSES_IGNORE);
+            m_requests.clear();
+        }
+
+        void free_message_types() {
+            for (int idx = 0; idx < _impl::static_pow3<DIMS>::value; ++idx) {
+                if (m_message_send_types[idx] != MPI_DATATYPE_NULL)
+                    MPI_Type_free(&m_message_send_types[idx]);
+                if (m_message_recv_types[idx] != MPI_DATATYPE_NULL)
+                    MPI_Type_free(&m_message_recv_types[idx]);
+            }
+        }
+
+        void free_datatypes() {
+            int finalized;
+            MPI_Finalized(&finalized);
+            if (m_mode != halo_exchange_mode::derived_datatypes || finalized)
+                return;
+            free_message_types();
+            for (int idx = 0; idx < _impl::static_pow3<DIMS>::value; ++idx) {
+                if (m_send_types[idx].second)
+                    MPI_Type_free(&m_send_types[idx].first);
+                if (m_recv_types[idx].second)
+                    MPI_Type_free(&m_recv_types[idx].first);
+            }
+        }
+
+        void free_node_window() {
+            int finalized;
+            MPI_Finalized(&finalized);
+            if (m_node_window == MPI_WIN_NULL || finalized)
+                return;
+            MPI_Win_unlock_all(m_node_window);
+            MPI_Win_free(&m_node_window);
+            MPI_Comm_free(&m_node_comm);
+        }
+
+        template <typename T>
+        static void set_message_sizes(T &hm, size_t n_fields) {
+            hm.m_packed_fields = n_fields;
+            for_each_neighbor(hm, [&](gridtools::array<int, 3> const &eta, int ii_P, int jj_P, int kk_P) {
+                const int idx = translate()(eta[0], eta[1], eta[2]);
+                const int mpi_fields = hm.on_node(idx) || hm.m_self[idx] ? 0 : n_fields;
+                hm.m_haloexch.set_send_to_size(hm.send_size[idx] * mpi_fields * sizeof(DataType), ii_P, jj_P, kk_P);
+                hm.m_haloexch.set_receive_from_size(
+                    hm.recv_size[idx] * mpi_fields * sizeof(DataType), ii_P, jj_P, kk_P);
+            });
+        }
+
+        /*
+          The (un)packing of all neighbors and fields happens in a single parallel region: every thread walks the
+          same sequence of buffers and copies its share of the rows of each of them, so that the work is balanced
+          even if there are few neighbors or the halos differ much in size.
+        */
         template <int I, int dummy>
         struct pack_dims {};
 
@@ -554,33 +1379,15 @@ namespace gridtools {
         struct pack_dims<3, dummy> {
             template <typename T, typename... FIELDS>
             void operator()(T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::at(0)];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::at(1)];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::at(2)];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.pack_all(make_array(ii, jj, kk), it, _fields...);
-
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                            }
-                        }
-                    }
-                }
+                set_message_sizes(hm, sizeof...(_fields));
+#pragma omp parallel
+                for_each_neighbor(hm, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (hm.m_self[idx])
+                        return;
+                    DataType *it = hm.send_ptr(idx);
+                    (void)std::initializer_list<int>{(hm.halo.pack_shared(eta, _fields, it), 0)...};
+                });
             }
         };
 
@@ -591,22 +1398,16 @@ namespace gridtools {
         struct unpack_dims<3, dummy> {
             template <typename T, typename... FIELDS>
             void operator()(const T &hm, const FIELDS &... _fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::at(0)];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::at(1)];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::at(2)];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                hm.halo.unpack_all(make_array(ii, jj, kk), it, _fields...);
-                            }
-                        }
+#pragma omp parallel
+                for_each_neighbor(hm, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (hm.m_self[idx]) {
+                        (void)std::initializer_list<int>{(hm.halo.copy_shared(eta, _fields), 0)...};
+                        return;
                     }
-                }
+                    DataType *it = hm.recv_ptr(idx);
+                    (void)std::initializer_list<int>{(hm.halo.unpack_shared(eta, _fields, it), 0)...};
+                });
             }
         };
 
@@ -617,35 +1418,16 @@ namespace gridtools {
         struct pack_vector_dims<3, dummy> {
             template <typename T>
             void operator()(T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::at(0)];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::at(1)];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::at(2)];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.pack(make_array(ii, jj, kk), fields[i], it);
-                                }
-
-                                hm.m_haloexch.set_send_to_size(
-                                    hm.send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                                hm.m_haloexch.set_receive_from_size(
-                                    hm.recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
-                                    ii_P,
-                                    jj_P,
-                                    kk_P);
-                            }
-                        }
-                    }
-                }
+                set_message_sizes(hm, fields.size());
+#pragma omp parallel
+                for_each_neighbor(hm, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (hm.m_self[idx])
+                        return;
+                    DataType *it = hm.send_ptr(idx);
+                    for (size_t i = 0; i < fields.size(); ++i)
+                        hm.halo.pack_shared(eta, fields[i], it);
+                });
             }
         };
 
@@ -656,24 +1438,18 @@ namespace gridtools {
         struct unpack_vector_dims<3, dummy> {
             template <typename T>
             void operator()(const T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typedef proc_layout map_type;
-                            const int ii_P = make_array(ii, jj, kk)[map_type::at(0)];
-                            const int jj_P = make_array(ii, jj, kk)[map_type::at(1)];
-                            const int kk_P = make_array(ii, jj, kk)[map_type::at(2)];
-                            if ((ii != 0 || jj != 0 || kk != 0) &&
-                                (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                for (size_t i = 0; i < fields.size(); ++i) {
-                                    hm.halo.unpack(make_array(ii, jj, kk), fields[i], it);
-                                }
-                            }
-                        }
+#pragma omp parallel
+                for_each_neighbor(hm, [&](gridtools::array<int, 3> const &eta, int, int, int) {
+                    const int idx = translate()(eta[0], eta[1], eta[2]);
+                    if (hm.m_self[idx]) {
+                        for (size_t i = 0; i < fields.size(); ++i)
+                            hm.halo.copy_shared(eta, fields[i]);
+                        return;
                     }
-                }
+                    DataType *it = hm.recv_ptr(idx);
+                    for (size_t i = 0; i < fields.size(); ++i)
+                        hm.halo.unpack_shared(eta, fields[i], it);
+                });
             }
         };
 
@@ -10,6 +10,33 @@
 #pragma once
 
 namespace gridtools {
+    /**
+       How the halos are exchanged by halo_exchange_dynamic_ut:
+       - all_neighbors: one message to each of the (up to) 26 neighbors, including those across edges and corners;
+       - by_dimension: the dimensions are exchanged one after the other with the face neighbors only, forwarding the
+         halos received along the previous dimensions so that edges and corners are filled as well. At most 6
+         messages are sent, but each step has to wait for the previous one: only the first dimension is in flight
+         between start_exchange and wait, the others are exchanged in wait.
+       - shared_memory: like all_neighbors, but the data for the neighbors running on the same node is packed
+         directly into their receive buffers, which live in an MPI-3 shared memory window, and no message is sent to
+         them. Off-node neighbors are still reached through MPI. The halos are still packed and unpacked, only the
+         copies inside the MPI library are saved; every exchange synchronizes each process with its neighbors on the
+         node (not the whole node) through empty messages.
+       - derived_datatypes: like all_neighbors, but nothing is packed: every message is described by an MPI derived
+         datatype covering the halo boxes of all the fields, and MPI gathers and scatters the data directly from and
+         into the fields.
+       - neighbor_collective: like all_neighbors, but all the messages are exchanged by a single
+         MPI_Ineighbor_alltoallw over a distributed graph communicator with an edge to each neighbor, leaving the
+         scheduling of the exchange to the MPI library.
+    */
+    enum class halo_exchange_mode {
+        all_neighbors,
+        by_dimension,
+        shared_memory,
+        derived_datatypes,
+        neighbor_collective
+    };
+
     template <typename DataType, typename>
     class hndlr_descriptor_ut;
 
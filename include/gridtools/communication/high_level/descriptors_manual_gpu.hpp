@@ -8,6 +8,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdexcept>
 #include <utility>
 
 #ifdef __CUDACC__
@@ -169,8 +170,11 @@ namespace gridtools {
            Function to setup internal data structures for data exchange and preparing eventual underlying layers
 
            \param max_fields_n Maximum number of data fields that will be passed to the communication functions
+           \param mode How the halos are exchanged, only halo_exchange_mode::all_neighbors is supported
         */
-        void setup(const int max_fields_n) {
+        void setup(const int max_fields_n, halo_exchange_mode mode = halo_exchange_mode::all_neighbors) {
+            if (mode != halo_exchange_mode::all_neighbors)
+                throw std::runtime_error("only halo_exchange_mode::all_neighbors is supported on gcl_gpu");
 
             typedef translate_t<3, default_layout_map<3>::type> translate;
             typedef translate_t<3, proc_layout> translate_P;
@@ -416,6 +420,8 @@ namespace gridtools {
                 dangeroushalo_r /*halo.raw_array()*/,
                 DIMS * sizeof(halo_descriptor),
                 cudaMemcpyHostToDevice));
+
+            base_type::m_haloexch.enable_persistent_requests();
         }
 
         /**
@@ -657,6 +663,23 @@ namespace gridtools {
                 m_unpackXU(fields, d_recv_buffer, d_recv_size, dangeroushalo_r, halo_d_r);
             }
         }
+
+        /**
+           Function to complete an exchange started with start_exchange() and unpack the received data. The
+           unpacking kernels work on all the neighbors at once, so the data is unpacked after all messages arrived.
+
+           \param[in] fields data fields where to unpack data
+        */
+        template <typename... Pointers>
+        void wait_and_unpack(Pointers *... fields) {
+            base_type::wait();
+            unpack(fields...);
+        }
+
+        void wait_and_unpack(std::vector<DataType *> const &fields) {
+            base_type::wait();
+            unpack(fields);
+        }
     };
 #endif
 } // namespace gridtools
@@ -9,17 +9,19 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <iomanip>
 #include <map>
 #include <numeric>
 #include <set>
+#include <string>
 #include <vector>
 
 #include <mpi.h>
 
 #include "../../common/halo_descriptor.hpp"
-#include "../common/array.hpp"
-#include "../common/boollist.hpp"
+#include "../../common/array.hpp"
+#include "../../common/boollist.hpp"
 
 namespace gridtools {
 
@@ -33,7 +35,8 @@ namespace gridtools {
         ee_start_exchange,
         ee_wait,
         ee_post_receives,
-        ee_do_sends
+        ee_do_sends,
+        ee_boundary // boundary conditions applied by distributed_boundaries, not associated to a pattern
     };
 
     struct ExchangeEvent {
@@ -73,7 +76,7 @@ namespace gridtools {
     template <int DIM>
     struct Pattern {
         typedef array<halo_descriptor, DIM> halo_array;
-        typedef gcl_utils::boollist<DIM> ptype;
+        typedef boollist<DIM> ptype;
 
         std::vector<int> proc_map;
         PatternType type;
@@ -84,7 +87,7 @@ namespace gridtools {
 
         Pattern(
             PatternType t, const halo_array &h, std::vector<int> map, const ptype &c, int coords_[DIM], int dims_[DIM])
-            : type(t), halos(h), proc_map(map) {
+            : proc_map(map), type(t), halos(h) {
             c.copy_out(periodicity);
             std::copy(coords_, coords_ + DIM, coords);
             std::copy(dims_, dims_ + DIM, dims);
@@ -96,20 +99,91 @@ namespace gridtools {
         }
     };
 
+    // fixed capacity storage for events: when full, a new event overwrites the oldest one, so that recording never
+    // allocates and the most recent history is kept
+    template <typename Event>
+    class event_ring {
+        std::vector<Event> m_events;
+        std::size_t m_capacity;
+        std::size_t m_oldest = 0;
+        std::size_t m_dropped = 0;
+
+      public:
+        // iterates over the events from the oldest to the most recent
+        class const_iterator {
+            event_ring const *m_ring;
+            std::size_t m_index;
+
+          public:
+            const_iterator(event_ring const *ring, std::size_t index) : m_ring(ring), m_index(index) {}
+
+            Event const &operator*() const { return (*m_ring)[m_index]; }
+            Event const *operator->() const { return &(*m_ring)[m_index]; }
+            const_iterator &operator++() {
+                ++m_index;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++m_index;
+                return tmp;
+            }
+            const_iterator operator+(std::size_t n) const { return {m_ring, m_index + n}; }
+            bool operator==(const_iterator const &other) const { return m_index == other.m_index; }
+            bool operator!=(const_iterator const &other) const { return m_index != other.m_index; }
+        };
+
+        explicit event_ring(std::size_t capacity) : m_capacity(capacity) { m_events.reserve(capacity); }
+
+        void push_back(Event const &event) {
+            if (m_events.size() < m_capacity) {
+                m_events.push_back(event);
+            } else if (m_capacity > 0) {
+                m_events[m_oldest] = event;
+                m_oldest = (m_oldest + 1) % m_capacity;
+                ++m_dropped;
+            } else {
+                ++m_dropped;
+            }
+        }
+
+        // discards all the events and sets the capacity (the only point where memory is allocated)
+        void reset(std::size_t capacity) {
+            m_events.clear();
+            m_events.shrink_to_fit();
+            m_capacity = capacity;
+            m_events.reserve(capacity);
+            m_oldest = 0;
+            m_dropped = 0;
+        }
+
+        Event const &operator[](std::size_t i) const { return m_events[(m_oldest + i) % m_events.size()]; }
+        std::size_t size() const { return m_events.size(); }
+        std::size_t capacity() const { return m_capacity; }
+        // number of events overwritten since the last reset
+        std::size_t dropped() const { return m_dropped; }
+
+        const_iterator begin() const { return {this, 0}; }
+        const_iterator end() const { return {this, m_events.size()}; }
+    };
+
     // singleton for collecting run time statistics about communication
     template <int DIM>
     class stats_collector {
       public:
         typedef stats_collector<DIM> collector;
-        typedef std::vector<CommEvent>::iterator event_iterator;
-        typedef std::vector<CommEvent>::const_iterator const_event_iterator;
-        typedef std::vector<ExchangeEvent>::iterator exchange_iterator;
-        typedef std::vector<ExchangeEvent>::const_iterator const_exchange_iterator;
+        typedef typename event_ring<CommEvent>::const_iterator event_iterator;
+        typedef typename event_ring<CommEvent>::const_iterator const_event_iterator;
+        typedef typename event_ring<ExchangeEvent>::const_iterator exchange_iterator;
+        typedef typename event_ring<ExchangeEvent>::const_iterator const_exchange_iterator;
         typedef typename std::vector<Pattern<DIM>>::iterator pattern_iterator;
         typedef typename std::vector<Pattern<DIM>>::const_iterator const_pattern_iterator;
 
         // get instance of the stats_collector singleton
-        static collector *instance() { return instance_ ? instance_ : (instance_ = new collector); }
+        static collector *instance() {
+            static collector *const res = new collector;
+            return res;
+        }
 
         // intialized the singleton
         // performs a syncronization across all MPI processes and records a time stamp
@@ -118,7 +192,13 @@ namespace gridtools {
             if (initialized_)
                 return;
 
-            comm_ = comm;
+            // the communicator of the pattern is freed with the pattern
+            MPI_Comm_dup(comm, &comm_);
+            // the duplicate is freed by an attribute of MPI_COMM_SELF, which MPI_Finalize deletes first
+            int keyval;
+            MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, &finalize_attribute, &keyval, this);
+            MPI_Comm_set_attr(MPI_COMM_SELF, keyval, this);
+            MPI_Comm_free_keyval(&keyval);
             // perform barrier syncronization
             MPI_Barrier(comm_);
             MPI_Comm_rank(comm, &rank);
@@ -130,6 +210,14 @@ namespace gridtools {
             initialized_ = true;
         }
 
+        // frees the communicator duplicated by init(); called by MPI_Finalize, the events are kept
+        void finalize() {
+            if (!initialized_)
+                return;
+            MPI_Comm_free(&comm_);
+            initialized_ = false;
+        }
+
         // add a low-level MPI event
         void add_event(const CommEvent &event) {
             if (recording_)
@@ -179,6 +267,87 @@ namespace gridtools {
         // toggle recording on or off. recording is set to false, calls to add_event() are ignored.
         void recording(bool state) { recording_ = state; }
 
+        // discards the events recorded so far and sets how many of the most recent events of each kind are kept
+        void set_capacity(std::size_t exchange_events, std::size_t comm_events) {
+            exchange_events_.reset(exchange_events);
+            events_.reset(comm_events);
+        }
+
+        // number of events overwritten because the buffers were full
+        std::size_t dropped_exchange_events() const { return exchange_events_.dropped(); }
+        std::size_t dropped_events() const { return events_.dropped(); }
+
+        /**
+           Writes the events recorded by this rank in the Chrome trace event format (JSON), that can be loaded in
+           Perfetto or chrome://tracing. Each rank is a process, the exchange events are on thread 0 and the MPI
+           events on thread 1. Time stamps are in microseconds from the time stamp taken after the barrier in init(),
+           so that the traces of different ranks are aligned.
+         */
+        template <typename S>
+        void export_chrome_trace(S &stream) const {
+            stream << std::fixed << std::setprecision(3);
+            stream << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"rank\":" << rank << ",\"size\":" << size
+                   << ",\"dropped_exchange_events\":" << dropped_exchange_events()
+                   << ",\"dropped_events\":" << dropped_events() << "},\n\"traceEvents\":[\n";
+            stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"rank "
+                   << rank << "\"}}";
+            for (const_exchange_iterator it = exchange_begin(); it != exchange_end(); it++) {
+                trace_event_begin(stream,
+                    exchange_labels().at(it->type).c_str(),
+                    "exchange",
+                    0,
+                    it->wall_time_start,
+                    it->wall_time_end);
+                stream << "\"pattern\":" << it->pattern << ",\"fields\":" << it->fields << "}}";
+            }
+            for (const_event_iterator it = events_begin(); it != events_end(); it++) {
+                trace_event_begin(
+                    stream, event_labels().at(it->type).c_str(), "mpi", 1, it->wall_time_start, it->wall_time_end);
+                stream << "\"pattern\":" << it->pattern << ",\"other_rank\":" << it->other_rank
+                       << ",\"tag\":" << it->tag << ",\"size\":" << it->message_size << "}}";
+            }
+            stream << "\n]}\n";
+        }
+
+        /**
+           Writes the events recorded by this rank in a compact binary format, in the native byte order:
+           - header: "GCLT", uint32 version (1), int32 rank, int32 size, double initial time stamp (MPI_Wtime after
+             the barrier in init()), uint64 numbers of exchange events, MPI events, dropped exchange events and
+             dropped MPI events;
+           - exchange events: int32 type (ExchangeEventType), int32 pattern, int32 fields, double start, double end;
+           - MPI events: int32 type (CommEventType), int32 pattern, int32 other rank, int32 tag, int32 size,
+             double start, double end.
+           Times are in seconds relative to the initial time stamp.
+         */
+        template <typename S>
+        void export_binary(S &stream) const {
+            stream.write("GCLT", 4);
+            write_raw(stream, std::uint32_t(1));
+            write_raw(stream, std::int32_t(rank));
+            write_raw(stream, std::int32_t(size));
+            write_raw(stream, initial_time_stamp_);
+            write_raw(stream, std::uint64_t(exchange_events_.size()));
+            write_raw(stream, std::uint64_t(events_.size()));
+            write_raw(stream, std::uint64_t(dropped_exchange_events()));
+            write_raw(stream, std::uint64_t(dropped_events()));
+            for (const_exchange_iterator it = exchange_begin(); it != exchange_end(); it++) {
+                write_raw(stream, std::int32_t(it->type));
+                write_raw(stream, std::int32_t(it->pattern));
+                write_raw(stream, std::int32_t(it->fields));
+                write_raw(stream, it->wall_time_start - initial_time_stamp_);
+                write_raw(stream, it->wall_time_end - initial_time_stamp_);
+            }
+            for (const_event_iterator it = events_begin(); it != events_end(); it++) {
+                write_raw(stream, std::int32_t(it->type));
+                write_raw(stream, std::int32_t(it->pattern));
+                write_raw(stream, std::int32_t(it->other_rank));
+                write_raw(stream, std::int32_t(it->tag));
+                write_raw(stream, std::int32_t(it->message_size));
+                write_raw(stream, it->wall_time_start - initial_time_stamp_);
+                write_raw(stream, it->wall_time_end - initial_time_stamp_);
+            }
+        }
+
         // print information about communicatio pattern that is required
         // to reproduce communication
         template <typename S>
@@ -186,7 +355,8 @@ namespace gridtools {
             // determine which subset of patterns were actually used
             std::set<int> patterns_used;
             for (const_exchange_iterator it = exchange_begin(); it != exchange_end(); it++)
-                patterns_used.insert(it->pattern);
+                if (it->pattern >= 0)
+                    patterns_used.insert(it->pattern);
 
             // enumerate the patterns from 0:patterns_used.size()-1
             std::map<int, int> pattern_map;
@@ -299,8 +469,9 @@ namespace gridtools {
             for (std::map<int, int>::const_iterator it = pattern_map.begin(); it != pattern_map.end(); it++) {
                 pattern_times[it->first] = time_table;
             }
-            for (std::vector<ExchangeEvent>::const_iterator it = exchange_events_.begin(); it != exchange_events_.end();
-                 it++) {
+            for (const_exchange_iterator it = exchange_begin(); it != exchange_end(); it++) {
+                if (it->pattern < 0)
+                    continue;
                 double dt = it->wall_time_end - it->wall_time_start;
                 pattern_times[it->pattern][it->type] += dt;
             }
@@ -414,20 +585,6 @@ namespace gridtools {
         //          and low-level MPI calls
         template <typename S>
         void print(S &stream, int level = 1) const {
-            // map of event types onto their names for printing
-            std::map<CommEventType, std::string> event_labels;
-            event_labels[ce_send] = std::string("send");
-            event_labels[ce_receive_wait] = std::string("receive_wait");
-            event_labels[ce_send_wait] = std::string("send_wait");
-            event_labels[ce_receive] = std::string("receive");
-
-            std::map<ExchangeEventType, std::string> exchange_labels;
-            exchange_labels[ee_pack] = std::string("pack");
-            exchange_labels[ee_unpack] = std::string("unpack");
-            exchange_labels[ee_exchange] = std::string("exchange");
-            exchange_labels[ee_start_exchange] = std::string("start exchg");
-            exchange_labels[ee_wait] = std::string("wait");
-
             std::map<PatternType, std::string> pattern_labels;
             pattern_labels[pt_dynamic] = std::string("dynamic");
             pattern_labels[pt_generic] = std::string("generic");
@@ -479,7 +636,7 @@ namespace gridtools {
                         "%8d%6d%14s%5d%6d%12d%11.5f%13.10f",
                         it->pattern,
                         idx,
-                        event_labels[it->type].c_str(),
+                        event_labels().at(it->type).c_str(),
                         it->other_rank,
                         it->tag,
                         it->message_size,
@@ -502,7 +659,7 @@ namespace gridtools {
                         "%8d%6d%14s%7d%11.5f%11.8f",
                         it->pattern,
                         idx,
-                        exchange_labels[it->type].c_str(),
+                        exchange_labels().at(it->type).c_str(),
                         it->fields,
                         it->wall_time_start - initial_time_stamp_,
                         it->wall_time_end - it->wall_time_start);
@@ -513,25 +670,58 @@ namespace gridtools {
         }
 
       private:
-        stats_collector() : recording_(false), initialized_(false) {
-            // reserve space for storing events and patterns to avoid memory
-            // allocation overheads during profiling
-            events_.reserve(1023);
-            exchange_events_.reserve(1023);
+        // the events are kept in preallocated buffers to avoid memory allocation overheads during profiling
+        stats_collector() : events_(1 << 16), exchange_events_(1 << 14), recording_(false), initialized_(false) {
             patterns_.reserve(63);
         };
-        stats_collector(collector const &){};
 
-        // instance of singleton
-        static collector *instance_;
+        // map of event types onto their names for printing and exporting
+        static std::map<CommEventType, std::string> const &event_labels() {
+            static const std::map<CommEventType, std::string> labels = {{ce_send, "send"},
+                {ce_receive_wait, "receive_wait"},
+                {ce_send_wait, "send_wait"},
+                {ce_receive, "receive"}};
+            return labels;
+        }
+
+        static std::map<ExchangeEventType, std::string> const &exchange_labels() {
+            static const std::map<ExchangeEventType, std::string> labels = {{ee_pack, "pack"},
+                {ee_unpack, "unpack"},
+                {ee_exchange, "exchange"},
+                {ee_start_exchange, "start exchg"},
+                {ee_wait, "wait"},
+                {ee_post_receives, "post receives"},
+                {ee_do_sends, "do sends"},
+                {ee_boundary, "boundary"}};
+            return labels;
+        }
+
+        static int finalize_attribute(MPI_Comm, int, void *, void *self) {
+            static_cast<collector *>(self)->finalize();
+            return MPI_SUCCESS;
+        }
+
+        template <typename S>
+        void trace_event_begin(S &stream, char const *name, char const *category, int tid, double start, double end)
+            const {
+            stream << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":" << rank
+                   << ",\"tid\":" << tid << ",\"ts\":" << (start - initial_time_stamp_) * 1e6
+                   << ",\"dur\":" << (end - start) * 1e6 << ",\"args\":{";
+        }
+
+        template <typename S, typename T>
+        static void write_raw(S &stream, T const &value) {
+            stream.write(reinterpret_cast<char const *>(&value), sizeof(T));
+        }
+        stats_collector(collector const &){};
 
         // time stamp after MPI syncronization at initialization
         // all subsequently stored time values are relative to this
         double initial_time_stamp_;
 
-        // list of all recorded events
-        std::vector<CommEvent> events_;
-        std::vector<ExchangeEvent> exchange_events_;
+        // the most recent recorded events
+        event_ring<CommEvent> events_;
+        event_ring<ExchangeEvent> exchange_events_;
 
         // flag whether to record events
         bool recording_;
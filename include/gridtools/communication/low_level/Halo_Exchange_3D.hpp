@@ -9,6 +9,10 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #ifdef GT_VERBOSE
 #include <iostream>
 #endif
@@ -16,6 +20,7 @@
 #include "../../common/defs.hpp"
 #include "../GCL.hpp"
 #include "has_communicator.hpp"
+#include "progress_thread.hpp"
 #include "translate.hpp"
 
 /** \file
@@ -216,37 +221,116 @@ namespace gridtools {
             char *&buffer(int I, int J, int K) { return m_buffers[translate()(I, J, K)]; }
             int &size(int I, int J, int K) { return m_size[translate()(I, J, K)]; }
             int size(int I, int J, int K) const { return m_size[translate()(I, J, K)]; }
-        };
-
-        template <int I, int J, int K>
-        struct TAG {
-            static const int value = (K + 1) * 9 + (I + 1) * 3 + J + 1;
-        };
 
-        struct request_t {
-            MPI_Request request[27];
-            MPI_Request &operator()(int i, int j, int k) { return request[translate()(i, j, k)]; }
+            bool operator==(sr_buffers const &other) const {
+                return std::equal(m_buffers, m_buffers + 27, other.m_buffers) &&
+                       std::equal(m_size, m_size + 27, other.m_size);
+            }
         };
 
-        struct request_t_mark : request_t {
-            bool mark[27];
-            request_t_mark() {
-                for (int i = 0; i < 27; ++i)
-                    mark[i] = false;
-            }
+        static int tag(int I, int J, int K) { return (K + 1) * 9 + (I + 1) * 3 + J + 1; }
+
+        // polled by the progress thread, returns true when all the messages of the exchange have completed
+        bool test_requests() {
+            int received = m_progress.arrived.load(std::memory_order_relaxed);
+            if (received < m_recv_requests.count) {
+                int n_completed;
+                int completed[26];
+                MPI_Testsome(
+                    m_recv_requests.count, m_recv_requests.requests, &n_completed, completed, MPI_STATUSES_IGNORE);
+                if (n_completed != MPI_UNDEFINED && n_completed > 0) {
+                    for (int n = 0; n < n_completed; ++n)
+                        m_progress.order[received + n] = completed[n];
+                    received += n_completed;
+                    m_progress.arrived.store(received, std::memory_order_release);
+                }
+                if (received < m_recv_requests.count)
+                    return false;
+            }
+            int sent;
+            MPI_Testall(m_send_requests.count, m_send_requests.requests, &sent, MPI_STATUSES_IGNORE);
+            if (!sent)
+                return false;
+            m_progress.done.store(true, std::memory_order_release);
+            return true;
+        }
 
-            bool marked(int i, int j, int k) const { return mark[translate()(i, j, k)]; }
+        void wait_progress() {
+            while (!m_progress.done.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            m_progress.handed_off = false;
+            if (!m_recv_requests.persistent)
+                m_recv_requests.count = 0;
+            if (!m_send_requests.persistent)
+                m_send_requests.count = 0;
+        }
 
-            void set(int i, int j, int k) { mark[translate()(i, j, k)] = true; }
+        /*
+          The requests of the messages in flight in one direction. Persistent requests are created once with
+          MPI_Send_init/MPI_Recv_init and restarted at every exchange; they are rebuilt only if the buffers or the
+          sizes registered with the pattern changed since they were created.
+        */
+        struct request_list {
+            MPI_Request requests[26];
+            int neighbors[26][3]; // relative coordinates of the process at the other end of each request
+            int count = 0;
+            bool persistent = false;
+            sr_buffers built_for;
+
+            request_list() = default;
+            // requests cannot be shared: a copy rebuilds its own when first used
+            request_list(request_list const &other) : persistent(other.persistent) {}
+            request_list &operator=(request_list const &) = delete;
+            ~request_list() { free(); }
+
+            void free() {
+                int finalized;
+                MPI_Finalized(&finalized);
+                if (persistent && !finalized)
+                    for (int i = 0; i < count; ++i)
+                        MPI_Request_free(&requests[i]);
+                count = 0;
+            }
+
+            bool up_to_date(sr_buffers const &buffers) const { return built_for == buffers; }
+
+            MPI_Request *add(int I, int J, int K) {
+                neighbors[count][0] = I;
+                neighbors[count][1] = J;
+                neighbors[count][2] = K;
+                return &requests[count++];
+            }
+
+            void wait_all() {
+                MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+                if (!persistent)
+                    count = 0;
+            }
+        };
 
-            void reset(int i, int j, int k) { mark[translate()(i, j, k)] = false; }
+        /*
+          Completion state of an exchange handed to the progress thread: the thread publishes the indices of the
+          receive requests in the order in which they complete, and flags the end of the exchange once the sends are
+          done as well.
+        */
+        struct progress_state {
+            std::atomic<int> arrived{0};
+            int order[26];
+            std::atomic<bool> done{true};
+            bool handed_off = false;
+
+            progress_state() = default;
+            progress_state(progress_state const &) {}
+            progress_state &operator=(progress_state const &) = delete;
         };
 
         sr_buffers m_send_buffers;
         sr_buffers m_recv_buffers;
 
-        request_t request;
-        request_t_mark send_request;
+        request_list m_recv_requests;
+        request_list m_send_requests;
+
+        progress_state m_progress;
 
         const PROC_GRID /*&*/ m_proc_grid;
 
@@ -256,7 +340,7 @@ namespace gridtools {
 #ifdef GT_VERBOSE
                 std::cout << "@" << gridtools::PID << "@ IRECV (" << I << "," << J << "," << K << ") "
                           << " P " << m_proc_grid.template proc<I, J, K>() << " - "
-                          << " T " << TAG<-I, -J, -K>::value << " - "
+                          << " T " << tag(-I, -J, -K) << " - "
                           << " R " << translate()(-I, -J, -K) << " - "
                           << " Amount " << m_recv_buffers.size(I, J, K) << "\n";
 #endif
@@ -269,14 +353,14 @@ namespace gridtools {
                     m_recv_buffers.size(I, J, K),
                     MPI_CHAR,
                     m_proc_grid.template proc<I, J, K>(),
-                    TAG<-I, -J, -K>::value,
+                    tag(-I, -J, -K),
                     get_communicator(m_proc_grid),
-                    &request(-I, -J, -K));
+                    m_recv_requests.add(I, J, K));
 #ifdef GCL_TRACE
                 double end_time = MPI_Wtime();
                 stats_collector_3D.add_event(CommEvent(ce_receive,
                     m_proc_grid.template proc<I, J, K>(),
-                    TAG<-I, -J, -K>::value,
+                    tag(-I, -J, -K),
                     m_recv_buffers.size(I, J, K),
                     begin_time,
                     end_time,
@@ -291,7 +375,7 @@ namespace gridtools {
 #ifdef GT_VERBOSE
                 std::cout << "@" << gridtools::PID << "@ ISEND (" << I << "," << J << "," << K << ") "
                           << " P " << m_proc_grid.template proc<I, J, K>() << " - "
-                          << " T " << TAG<I, J, K>::value << " - "
+                          << " T " << tag(I, J, K) << " - "
                           << " R " << translate()(I, J, K) << " - "
                           << " Amount " << m_send_buffers.size(I, J, K) << "\n";
 #endif
@@ -304,16 +388,14 @@ namespace gridtools {
                     m_send_buffers.size(I, J, K),
                     MPI_CHAR,
                     m_proc_grid.template proc<I, J, K>(),
-                    TAG<I, J, K>::value,
+                    tag(I, J, K),
                     get_communicator(m_proc_grid),
-                    &send_request(I, J, K));
-
-                send_request.set(I, J, K);
+                    m_send_requests.add(I, J, K));
 #ifdef GCL_TRACE
                 double end_time = MPI_Wtime();
                 stats_collector_3D.add_event(CommEvent(ce_send,
                     m_proc_grid.template proc<I, J, K>(),
-                    TAG<I, J, K>::value,
+                    tag(I, J, K),
                     m_send_buffers.size(I, J, K),
                     begin_time,
                     end_time,
@@ -322,57 +404,38 @@ namespace gridtools {
             }
         }
 
-        void wait_for_sends() {
-            MPI_Status status;
+        void init_persistent_receives() {
+            m_recv_requests.free();
             for (int i = -1; i <= 1; ++i)
                 for (int j = -1; j <= 1; ++j)
                     for (int k = -1; k <= 1; ++k)
-                        if (send_request.marked(i, j, k)) {
-#ifdef GCL_TRACE
-                            double begin_time = MPI_Wtime();
-#endif
-                            MPI_Wait(&send_request(i, j, k), &status);
-#ifdef GCL_TRACE
-                            double end_time = MPI_Wtime();
-                            stats_collector_3D.add_event(CommEvent(ce_send_wait,
-                                // m_proc_grid.template proc<I,J,K>(),
+                        if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                            m_recv_buffers.size(i, j, k))
+                            MPI_Recv_init(m_recv_buffers.buffer(i, j, k),
+                                m_recv_buffers.size(i, j, k),
+                                MPI_CHAR,
                                 m_proc_grid.proc(i, j, k),
-                                // TAG<I,J,K>::value,
-                                -1,
-                                m_send_buffers.size(i, j, k),
-                                begin_time,
-                                end_time,
-                                pattern_tag));
-#endif
-                            send_request.reset(i, j, k);
-                        }
+                                tag(-i, -j, -k),
+                                get_communicator(m_proc_grid),
+                                m_recv_requests.add(i, j, k));
+            m_recv_requests.built_for = m_recv_buffers;
         }
 
-        template <int I, int J, int K>
-        void wait() {
-            if (m_recv_buffers.size(I, J, K)) {
-#ifdef GT_VERBOSE
-                std::cout << "@" << gridtools::PID << "@ WAIT  (" << I << "," << J << "," << K << ") "
-                          << " R " << translate()(-I, -J, -K) << "\n";
-#endif
-
-#ifdef GCL_TRACE
-                double begin_time = MPI_Wtime();
-#endif
-
-                MPI_Status status;
-                MPI_Wait(&request(-I, -J, -K), &status);
-#ifdef GCL_TRACE
-                double end_time = MPI_Wtime();
-                stats_collector_3D.add_event(CommEvent(ce_receive_wait,
-                    m_proc_grid.template proc<I, J, K>(),
-                    TAG<-I, -J, -K>::value,
-                    m_recv_buffers.size(I, J, K),
-                    begin_time,
-                    end_time,
-                    pattern_tag));
-#endif
-            }
+        void init_persistent_sends() {
+            m_send_requests.free();
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k)
+                        if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                            m_send_buffers.size(i, j, k))
+                            MPI_Send_init(m_send_buffers.buffer(i, j, k),
+                                m_send_buffers.size(i, j, k),
+                                MPI_CHAR,
+                                m_proc_grid.proc(i, j, k),
+                                tag(i, j, k),
+                                get_communicator(m_proc_grid),
+                                m_send_requests.add(i, j, k));
+            m_send_requests.built_for = m_send_buffers;
         }
 
 #ifdef GCL_TRACE
@@ -397,7 +460,7 @@ namespace gridtools {
          *
          */
         explicit Halo_Exchange_3D(PROC_GRID /*const&*/ _pg)
-            : m_send_buffers(), m_recv_buffers(), request(), send_request(), m_proc_grid(_pg)
+            : m_send_buffers(), m_recv_buffers(), m_recv_requests(), m_send_requests(), m_proc_grid(_pg)
 #ifdef GCL_TRACE
               ,
               pattern_tag(-1)
@@ -666,7 +729,27 @@ namespace gridtools {
             wait();
         }
 
+        /** Switches the pattern to persistent MPI requests: the messages to and from all neighbors are set up once
+            (here, for the buffers registered so far) and every following exchange only restarts them. The requests
+            are rebuilt automatically if buffers or sizes are changed afterwards. Must not be called while an
+            exchange is in progress.
+         */
+        void enable_persistent_requests() {
+            m_recv_requests.persistent = true;
+            m_send_requests.persistent = true;
+            init_persistent_receives();
+            init_persistent_sends();
+        }
+
         void post_receives() {
+            if (m_recv_requests.persistent) {
+                if (!m_recv_requests.up_to_date(m_recv_buffers))
+                    init_persistent_receives();
+                MPI_Startall(m_recv_requests.count, m_recv_requests.requests);
+                return;
+            }
+            m_recv_requests.count = 0;
+
             /* Posting receives face -1
              */
             if (m_proc_grid.template proc<1, 0, -1>() != -1) {
@@ -785,6 +868,14 @@ namespace gridtools {
         }
 
         void do_sends() {
+            if (m_send_requests.persistent) {
+                if (!m_send_requests.up_to_date(m_send_buffers))
+                    init_persistent_sends();
+                MPI_Startall(m_send_requests.count, m_send_requests.requests);
+                return;
+            }
+            m_send_requests.count = 0;
+
             /* Sending data face -1
              */
             if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
@@ -905,7 +996,9 @@ namespace gridtools {
         /** When called this function initiate the data exchabge. When the
             function returns the data has to be considered already to be
             transfered. Buffers should not be considered safe to access
-            until the wait() function returns.
+            until the wait() function returns. If the progress thread is
+            running (see GCL_Init), the messages are handed to it and
+            progress while the caller computes.
          */
         void start_exchange() {
 
@@ -930,124 +1023,74 @@ namespace gridtools {
             // MPI_Barrier(GSL_WORLD);
 
             do_sends();
-        }
-
-        void wait() {
-
-            wait_for_sends();
-
-            /* Actual receives face -1
-             */
-            if (m_proc_grid.template proc<1, 0, -1>() != -1) {
-                wait<1, 0, -1>();
-            }
-
-            if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
-                wait<-1, 0, -1>();
-            }
-
-            if (m_proc_grid.template proc<0, 1, -1>() != -1) {
-                wait<0, 1, -1>();
-            }
-
-            if (m_proc_grid.template proc<0, -1, -1>() != -1) {
-                wait<0, -1, -1>();
-            }
-
-            if (m_proc_grid.template proc<1, 1, -1>() != -1) {
-                wait<1, 1, -1>();
-            }
-
-            if (m_proc_grid.template proc<-1, -1, -1>() != -1) {
-                wait<-1, -1, -1>();
-            }
-
-            if (m_proc_grid.template proc<-1, 1, -1>() != -1) {
-                wait<-1, 1, -1>();
-            }
-
-            if (m_proc_grid.template proc<1, -1, -1>() != -1) {
-                wait<1, -1, -1>();
-            }
-
-            if (m_proc_grid.template proc<0, 0, -1>() != -1) {
-                wait<0, 0, -1>();
-            }
-
-            /* Actual receives face 0
-             */
-            if (m_proc_grid.template proc<1, 0, 0>() != -1) {
-                wait<1, 0, 0>();
-            }
-
-            if (m_proc_grid.template proc<-1, 0, 0>() != -1) {
-                wait<-1, 0, 0>();
-            }
-
-            if (m_proc_grid.template proc<0, 1, 0>() != -1) {
-                wait<0, 1, 0>();
-            }
-
-            if (m_proc_grid.template proc<0, -1, 0>() != -1) {
-                wait<0, -1, 0>();
-            }
-
-            if (m_proc_grid.template proc<1, 1, 0>() != -1) {
-                wait<1, 1, 0>();
-            }
-
-            if (m_proc_grid.template proc<-1, -1, 0>() != -1) {
-                wait<-1, -1, 0>();
-            }
-
-            if (m_proc_grid.template proc<-1, 1, 0>() != -1) {
-                wait<-1, 1, 0>();
-            }
-
-            if (m_proc_grid.template proc<1, -1, 0>() != -1) {
-                wait<1, -1, 0>();
-            }
 
-            /* Actual receives face -1
-             */
-            if (m_proc_grid.template proc<1, 0, 1>() != -1) {
-                wait<1, 0, 1>();
-            }
-
-            if (m_proc_grid.template proc<-1, 0, 1>() != -1) {
-                wait<-1, 0, 1>();
-            }
-
-            if (m_proc_grid.template proc<0, 1, 1>() != -1) {
-                wait<0, 1, 1>();
-            }
-
-            if (m_proc_grid.template proc<0, -1, 1>() != -1) {
-                wait<0, -1, 1>();
-            }
-
-            if (m_proc_grid.template proc<1, 1, 1>() != -1) {
-                wait<1, 1, 1>();
-            }
-
-            if (m_proc_grid.template proc<-1, -1, 1>() != -1) {
-                wait<-1, -1, 1>();
-            }
-
-            if (m_proc_grid.template proc<-1, 1, 1>() != -1) {
-                wait<-1, 1, 1>();
-            }
-
-            if (m_proc_grid.template proc<1, -1, 1>() != -1) {
-                wait<1, -1, 1>();
+            if (_impl::progress_thread::instance().running()) {
+                m_progress.arrived.store(0, std::memory_order_relaxed);
+                m_progress.done.store(false, std::memory_order_relaxed);
+                m_progress.handed_off = true;
+                _impl::progress_thread::instance().submit([this] { return test_requests(); });
             }
+        }
 
-            if (m_proc_grid.template proc<0, 0, 1>() != -1) {
-                wait<0, 0, 1>();
+        void wait() {
+            if (m_progress.handed_off) {
+                wait_progress();
+                return;
             }
-
+#ifdef GCL_TRACE
+            double begin_time = MPI_Wtime();
+#endif
+            m_send_requests.wait_all();
+#ifdef GCL_TRACE
+            double end_time = MPI_Wtime();
+            stats_collector_3D.add_event(CommEvent(ce_send_wait, -1, -1, -1, begin_time, end_time, pattern_tag));
+            begin_time = end_time;
+#endif
+            m_recv_requests.wait_all();
+#ifdef GCL_TRACE
+            end_time = MPI_Wtime();
+            stats_collector_3D.add_event(CommEvent(ce_receive_wait, -1, -1, -1, begin_time, end_time, pattern_tag));
+#endif
             // MPI_Barrier(gridtools::GCL_WORLD);
         }
+
+        /** Like wait(), but calls `on_receive(I, J, K)` for every message as soon as it has arrived from the
+            neighbor with relative coordinates I, J, K, in the order in which the messages complete, so that the
+            received data can be consumed while other messages are still in flight.
+         */
+        template <typename F>
+        void wait(F const &on_receive) {
+            if (m_progress.handed_off) {
+                // the progress thread completes the requests, the messages are consumed here as they are published
+                for (int consumed = 0; consumed < m_recv_requests.count;) {
+                    int arrived = m_progress.arrived.load(std::memory_order_acquire);
+                    if (consumed == arrived)
+                        std::this_thread::yield();
+                    for (; consumed < arrived; ++consumed) {
+                        int const *neighbor = m_recv_requests.neighbors[m_progress.order[consumed]];
+                        on_receive(neighbor[0], neighbor[1], neighbor[2]);
+                    }
+                }
+                wait_progress();
+                return;
+            }
+            int completed[26];
+            for (int remaining = m_recv_requests.count; remaining > 0;) {
+                int n_completed;
+                MPI_Waitsome(
+                    m_recv_requests.count, m_recv_requests.requests, &n_completed, completed, MPI_STATUSES_IGNORE);
+                if (n_completed == MPI_UNDEFINED)
+                    break;
+                for (int n = 0; n < n_completed; ++n) {
+                    int const *neighbor = m_recv_requests.neighbors[completed[n]];
+                    on_receive(neighbor[0], neighbor[1], neighbor[2]);
+                }
+                remaining -= n_completed;
+            }
+            if (!m_recv_requests.persistent)
+                m_recv_requests.count = 0;
+            m_send_requests.wait_all();
+        }
     };
 
 } // namespace gridtools
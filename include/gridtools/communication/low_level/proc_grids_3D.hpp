@@ -211,6 +211,20 @@ namespace gridtools {
             return res;
         }
 
+        /** Returns whether the process with relative coordinates (I,J,K) is the caller process itself, which is the
+           case along the periodic dimensions of the process grid that have a single process.
+            \param[in] I Relative coordinate in the first dimension
+            \param[in] J Relative coordinate in the second dimension
+            \param[in] K Relative coordinate in the third dimension
+        */
+        bool is_self(int I, int J, int K) const {
+            int const offsets[3] = {I, J, K};
+            for (int d = 0; d < 3; ++d)
+                if (offsets[d] != 0 && (!m_cyclic.value(d) || m_dimensions[d] != 1))
+                    return false;
+            return true;
+        }
+
         GT_FUNCTION
         gridtools::array<int, ndims> const &coordinates() const { return m_coordinates; }
 
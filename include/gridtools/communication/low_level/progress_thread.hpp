@@ -0,0 +1,115 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../common/omp.hpp"
+
+namespace gridtools {
+    namespace _impl {
+        /**
+           Thread dedicated to the progress of the communication. Many MPI implementations progress the non-blocking
+           messages only inside MPI calls: while the OpenMP threads compute, a message started with
+           Halo_Exchange_3D::start_exchange would not move until Halo_Exchange_3D::wait. The patterns started while
+           this thread is running hand it a job that tests their requests until they complete, so that the
+           communication proceeds concurrently to the computation.
+
+           The thread is started by GCL_Init(argc, argv, gcl_progress::dedicated_thread) and reserves one of the
+           OpenMP threads: the default team size of the calling thread is reduced by one while it runs, so that the
+           backends sizing their work with omp_get_max_threads() use the remaining cores.
+         */
+        class progress_thread {
+          public:
+            // a job is polled until it returns true
+            using job_type = std::function<bool()>;
+
+          private:
+            std::thread m_thread;
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+            std::vector<job_type> m_submitted;
+            std::atomic<bool> m_running{false};
+            bool m_stop = false;
+            int m_omp_threads = 0;
+
+            progress_thread() = default;
+
+            void loop() {
+                std::vector<job_type> jobs;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        if (jobs.empty())
+                            m_cv.wait(lock, [this] { return m_stop || !m_submitted.empty(); });
+                        if (m_stop && jobs.empty() && m_submitted.empty())
+                            return;
+                        jobs.insert(jobs.end(), m_submitted.begin(), m_submitted.end());
+                        m_submitted.clear();
+                    }
+                    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](job_type const &job) { return job(); }),
+                        jobs.end());
+                    std::this_thread::yield();
+                }
+            }
+
+          public:
+            progress_thread(progress_thread const &) = delete;
+            progress_thread &operator=(progress_thread const &) = delete;
+            ~progress_thread() { stop(); }
+
+            static progress_thread &instance() {
+                static progress_thread thread;
+                return thread;
+            }
+
+            bool running() const { return m_running.load(std::memory_order_acquire); }
+
+            void start() {
+                if (running())
+                    return;
+                m_omp_threads = omp_get_max_threads();
+                if (m_omp_threads > 1)
+                    omp_set_num_threads(m_omp_threads - 1);
+                m_stop = false;
+                m_thread = std::thread([this] { loop(); });
+                m_running.store(true, std::memory_order_release);
+            }
+
+            /** Waits for the jobs still pending, then joins the thread and gives the core back to OpenMP. */
+            void stop() {
+                if (!running())
+                    return;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_cv.notify_one();
+                m_thread.join();
+                m_running.store(false, std::memory_order_release);
+                omp_set_num_threads(m_omp_threads);
+            }
+
+            void submit(job_type job) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_submitted.push_back(std::move(job));
+                }
+                m_cv.notify_one();
+            }
+        };
+    } // namespace _impl
+} // namespace gridtools
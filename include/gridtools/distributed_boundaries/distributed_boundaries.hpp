@@ -13,6 +13,8 @@
 /** \defgroup Distributed-Boundaries Distributed Boundary Conditions
  */
 
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -44,6 +46,13 @@ namespace gridtools {
     /** \ingroup Distributed-Boundaries
      * @{ */
 
+    /**
+        @brief Tag to be passed as first argument to gridtools::distributed_boundaries::exchange to unpack the data
+        received from each neighbor as soon as it arrives, instead of waiting for all messages before unpacking.
+    */
+    struct unpack_on_arrival_t {};
+    constexpr unpack_on_arrival_t unpack_on_arrival = {};
+
     /**
         @brief This class takes a communication traits class and provide a facility to
         perform boundary conditions and communications in a single call.
@@ -98,8 +107,25 @@ namespace gridtools {
         performance_meter_t m_meter_pack;
         performance_meter_t m_meter_exchange;
         performance_meter_t m_meter_bc;
+        performance_meter_t m_meter_overlap;
+
+        bool m_exchange_pending = false;
 
       public:
+        /**
+            @brief Handle to an exchange started with distributed_boundaries::start_exchange, to be passed to
+            distributed_boundaries::wait. It keeps the jobs whose halos have to be unpacked and whose boundary
+            conditions have to be applied when the exchange completes.
+        */
+        template <typename... Jobs>
+        class exchange_handle {
+            friend struct distributed_boundaries;
+
+            std::tuple<Jobs...> m_jobs;
+
+            exchange_handle(Jobs const &... jobs) : m_jobs{jobs...} {}
+        };
+
         /**
             @brief Constructor of distributed_boundaries.
 
@@ -115,7 +141,7 @@ namespace gridtools {
             array<halo_descriptor, 3> halos, boollist<3> period, uint_t max_stores, MPI_Comm CartComm)
             : m_halos{halos}, m_sizes{0, 0, 0}, m_max_stores{max_stores}, m_he(period, CartComm),
               m_meter_pack("pack/unpack       "), m_meter_exchange("exchange          "),
-              m_meter_bc("boundary condition") {
+              m_meter_bc("boundary condition"), m_meter_overlap("overlapped        ") {
 
             m_he.pattern().proc_grid().fill_dims(m_sizes);
 
@@ -146,9 +172,15 @@ namespace gridtools {
         template <typename... Jobs>
         void boundary_only(Jobs const &... jobs) {
             using execute_in_order = int[];
+#ifdef GCL_TRACE
+            double start_time = MPI_Wtime();
+#endif
             m_meter_bc.start();
             (void)execute_in_order{(apply_boundary(jobs), 0)...};
             m_meter_bc.pause();
+#ifdef GCL_TRACE
+            stats_collector_3D.add_event(ExchangeEvent(ee_boundary, start_time, MPI_Wtime(), sizeof...(jobs)));
+#endif
         }
 
         /**
@@ -164,47 +196,145 @@ namespace gridtools {
         */
         template <typename... Jobs>
         void exchange(Jobs const &... jobs) {
-            auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
-            if (m_max_stores < sizeof...(jobs)) {
-                std::string err{"Too many data stores to be exchanged" + std::to_string(sizeof...(jobs)) +
-                                " instead of the maximum allowed, which is " + std::to_string(m_max_stores)};
-                throw std::runtime_error(err);
-            }
+            exchange_impl(std::false_type(), jobs...);
+        }
 
+        /**
+            @brief Same as the other distributed_boundaries::exchange, but the data received from each neighbor is
+            unpacked as soon as it arrives, so that unpacking overlaps with the messages still in flight. The time
+            spent unpacking is accounted to the exchange meter in this case.
+
+            \param jobs Variadic list of jobs
+        */
+        template <typename... Jobs>
+        void exchange(unpack_on_arrival_t, Jobs const &... jobs) {
+            exchange_impl(std::true_type(), jobs...);
+        }
+
+        /**
+            @brief Non-blocking version of distributed_boundaries::exchange: the data stores are packed and the
+            communication is started, then the function returns so that computations not involving the halos
+            of the jobs can run while the messages are in flight. The exchange is completed, and the boundary
+            conditions applied, by distributed_boundaries::wait on the returned handle.
+
+            Only one exchange can be in flight at a time on a distributed_boundaries object, and the jobs must not
+            be modified before the corresponding wait.
+
+            \param jobs Variadic list of jobs
+            \return The handle to pass to distributed_boundaries::wait
+        */
+        template <typename... Jobs>
+        exchange_handle<Jobs...> start_exchange(Jobs const &... jobs) {
+            if (m_exchange_pending)
+                throw std::runtime_error("An exchange is already in flight: wait for it before starting a new one");
+            check_max_stores(jobs...);
+
+            auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
+            // the calls are counted by wait, once per exchange
             m_meter_pack.start();
             call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-            m_meter_pack.pause();
+            m_meter_pack.suspend();
             m_meter_exchange.start();
-            m_he.exchange();
-            m_meter_exchange.pause();
-            m_meter_pack.start();
-            call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-            m_meter_pack.pause();
+            m_he.start_exchange();
+            m_meter_exchange.suspend();
 
-            boundary_only(jobs...);
+            m_exchange_pending = true;
+            m_meter_overlap.start();
+            return {jobs...};
+        }
+
+        /**
+            @brief Completes an exchange started with distributed_boundaries::start_exchange: waits for the
+            messages, unpacks the halos and applies the boundary conditions of the jobs. The time between the start
+            of the exchange and the call to this function is accounted to the overlapped meter.
+
+            \param handle The handle returned by distributed_boundaries::start_exchange
+        */
+        template <typename... Jobs>
+        void wait(exchange_handle<Jobs...> const &handle) {
+            if (!m_exchange_pending)
+                throw std::runtime_error("No exchange in flight to wait for");
+            m_meter_overlap.pause();
+            m_exchange_pending = false;
+
+            wait_impl(handle.m_jobs, std::make_index_sequence<sizeof...(Jobs)>{});
         }
 
         typename pattern_type::grid_type const &proc_grid() const { return m_he.comm(); }
 
         std::string print_meters() const {
-            return m_meter_pack.to_string() + "\n" + m_meter_exchange.to_string() + "\n" + m_meter_bc.to_string();
+            return m_meter_pack.to_string() + "\n" + m_meter_exchange.to_string() + "\n" + m_meter_bc.to_string() +
+                   "\n" + m_meter_overlap.to_string();
         }
 
-        double get_time_pack() const { return m_meter_pack.get_time(); }
-        double get_time_exchange() const { return m_meter_exchange.get_time(); }
-        double get_time_boundary() const { return m_meter_bc.get_time(); }
+        double get_time_pack() const { return m_meter_pack.total_time(); }
+        double get_time_exchange() const { return m_meter_exchange.total_time(); }
+        double get_time_boundary() const { return m_meter_bc.total_time(); }
+        // time spent by the caller between distributed_boundaries::start_exchange and distributed_boundaries::wait
+        double get_time_overlap() const { return m_meter_overlap.total_time(); }
 
-        size_t get_count_exchange() const { return m_meter_exchange.get_count(); }
+        size_t get_count_exchange() const { return m_meter_exchange.count(); }
         // no get_count_pack() as it is equivalent to get_count_exchange()
-        size_t get_count_boundary() const { return m_meter_bc.get_count(); }
+        size_t get_count_boundary() const { return m_meter_bc.count(); }
+        size_t get_count_overlap() const { return m_meter_overlap.count(); }
 
         void reset_meters() {
-            m_meter_pack.reset_meter();
-            m_meter_exchange.reset_meter();
-            m_meter_bc.reset_meter();
+            m_meter_pack.reset();
+            m_meter_exchange.reset();
+            m_meter_bc.reset();
+            m_meter_overlap.reset();
         }
 
       private:
+        template <typename... Jobs>
+        void check_max_stores(Jobs const &... jobs) const {
+            if (m_max_stores < sizeof...(jobs)) {
+                std::string err{"Too many data stores to be exchanged" + std::to_string(sizeof...(jobs)) +
+                                " instead of the maximum allowed, which is " + std::to_string(m_max_stores)};
+                throw std::runtime_error(err);
+            }
+        }
+
+        template <typename JobsTuple, size_t... Ids>
+        void wait_impl(JobsTuple const &jobs, std::index_sequence<Ids...>) {
+            auto all_stores_for_exc = std::tuple_cat(collect_stores(std::get<Ids>(jobs))...);
+            m_meter_exchange.start();
+            m_he.wait();
+            m_meter_exchange.pause();
+            m_meter_pack.start();
+            call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(Ids)>{});
+            m_meter_pack.pause();
+
+            boundary_only(std::get<Ids>(jobs)...);
+        }
+
+        template <typename OnArrival, typename... Jobs>
+        void exchange_impl(OnArrival, Jobs const &... jobs) {
+            if (m_exchange_pending)
+                throw std::runtime_error("An exchange is already in flight: wait for it before starting a new one");
+            auto all_stores_for_exc = std::tuple_cat(collect_stores(jobs)...);
+            check_max_stores(jobs...);
+
+            m_meter_pack.start();
+            call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+            m_meter_pack.pause();
+            if (OnArrival::value) {
+                m_meter_exchange.start();
+                m_he.start_exchange();
+                call_wait_and_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                m_meter_exchange.pause();
+            } else {
+                m_meter_exchange.start();
+                m_he.exchange();
+                m_meter_exchange.pause();
+                m_meter_pack.start();
+                call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                m_meter_pack.pause();
+            }
+
+            boundary_only(jobs...);
+        }
+
         template <typename BoundaryApply, typename ArgsTuple, uint_t... Ids>
         static void call_apply(
             BoundaryApply boundary_apply, ArgsTuple const &args, std::integer_sequence<uint_t, Ids...>) {
@@ -253,6 +383,16 @@ namespace gridtools {
 
         template <typename Stores>
         static void call_unpack(Stores const &stores, std::integer_sequence<uint_t>) {}
+
+        template <typename Stores, uint_t... Ids>
+        void call_wait_and_unpack(Stores const &stores, std::integer_sequence<uint_t, Ids...>) {
+            m_he.wait_and_unpack(std::get<Ids>(stores)->get_target_ptr()...);
+        }
+
+        template <typename Stores>
+        void call_wait_and_unpack(Stores const &stores, std::integer_sequence<uint_t>) {
+            m_he.wait();
+        }
     };
 
     /** @} */
@@ -92,11 +92,18 @@ namespace gridtools {
 
             void exchange() {}
 
+            void start_exchange() {}
+
+            void wait() {}
+
             template <typename... As>
             void pack(As...) {}
 
             template <typename... As>
             void unpack(As...) {}
+
+            template <typename... As>
+            void wait_and_unpack(As...) {}
         };
 
     } // namespace mock_
@@ -7,18 +7,47 @@
  * Please, refer to the LICENSE file in the root directory.
  * SPDX-License-Identifier: BSD-3-Clause
  */
+
 #pragma once
 
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
 #include <cpp_bindgen/fortran_array_view.hpp>
 
+#include "../common/array.hpp"
+#include "../common/integral_constant.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "../sid/simple_ptr_holder.hpp"
 #include "../storage/data_store.hpp"
+#include "../storage/sid.hpp"
+#include "../storage/traits.hpp"
 #include "layout_transformation/layout_transformation.hpp"
 
+#ifdef __CUDACC__
+#include "../common/cuda_is_ptr.hpp"
+#endif
+
 namespace gridtools {
+    /**
+     * Adapter of a Fortran array to the data stores of type DataStorePtr.
+     *
+     * The Fortran array can be copied into and from a data store (transform_to, transform_from), or used directly:
+     * the adapter models the SID concept with the dimensions of the data store and the Fortran strides, so that it
+     * can be passed to run() without copy. The adapters of the same type share the strides kind, so the Fortran arrays
+     * passed to the same computation through adapters of the same type have to have the same dimensions; arrays with
+     * different dimensions have to be adapted to data stores of different kinds, e.g. built with different ids.
+     *
+     * adopt_or_transform uses the Fortran array directly only if it fulfills the requirements of the storage of
+     * DataStorePtr: same order of the strides, same memory space and same alignment. Otherwise it falls back to a copy.
+     */
     template <class DataStorePtr>
     class fortran_array_adapter {
         static_assert(storage::is_data_store_ptr<DataStorePtr>::value, "");
         using data_store_t = typename DataStorePtr::element_type;
+        using layout_t = typename data_store_t::layout_t;
         using lengths_t = std::decay_t<decltype(DataStorePtr()->lengths())>;
         using strides_t = std::decay_t<decltype(DataStorePtr()->strides())>;
         using data_ptr_t = decltype(DataStorePtr()->get_target_ptr());
@@ -34,7 +63,7 @@ namespace gridtools {
         void check_fortran_lengths(DataStorePtr const &ds) const {
             auto &&lengths = ds->lengths();
             auto &&strides = ds->strides();
-            for (size_t c_dim = 0, fortran_dim = 0; c_dim < data_store_t::layout_t::masked_length; ++c_dim)
+            for (size_t c_dim = 0, fortran_dim = 0; c_dim < layout_t::masked_length; ++c_dim)
                 if (strides[c_dim] != 0) {
                     if (m_descriptor.dims[fortran_dim] != lengths[c_dim])
                         throw std::runtime_error("dimensions do not match (descriptor [" +
@@ -44,19 +73,57 @@ namespace gridtools {
                 }
         }
 
-        strides_t fortran_strides(DataStorePtr const &ds) const {
-            auto &&lengths = ds->lengths();
-            auto &&strides = ds->strides();
+        // the lengths of the Fortran array in the dimensions of the data store, 1 in the masked dimensions
+        lengths_t fortran_lengths() const {
+            lengths_t res = {};
+            for (size_t c_dim = 0, fortran_dim = 0; c_dim < res.size(); ++c_dim)
+                res[c_dim] = layout_t::at(c_dim) < 0 ? 1 : m_descriptor.dims[fortran_dim++];
+            return res;
+        }
+
+        strides_t fortran_strides() const {
+            auto lengths = fortran_lengths();
             strides_t res = {};
             uint_t current_stride = 1;
             for (size_t i = 0; i < res.size(); ++i)
-                if (strides[i] != 0) {
+                if (layout_t::at(i) >= 0) {
                     res[i] = current_stride;
                     current_stride *= lengths[i];
                 }
             return res;
         }
 
+        // the strides of the Fortran array grow with the dimension, the layout has to have the same order
+        static constexpr bool has_fortran_layout() {
+            int expected = layout_t::unmasked_length - 1;
+            for (size_t i = 0; i != layout_t::masked_length; ++i)
+                if (layout_t::at(i) >= 0 && layout_t::at(i) != expected--)
+                    return false;
+            return true;
+        }
+
+        friend sid::simple_ptr_holder<data_ptr_t> sid_get_origin(fortran_array_adapter const &obj) {
+            return {obj.fortran_ptr()};
+        }
+        friend array<int_t, layout_t::masked_length> sid_get_strides(fortran_array_adapter const &obj) {
+            auto &&strides = obj.fortran_strides();
+            array<int_t, layout_t::masked_length> res;
+            for (size_t i = 0; i != res.size(); ++i)
+                res[i] = strides[i];
+            return res;
+        }
+        friend meta::list<fortran_array_adapter> sid_get_strides_kind(fortran_array_adapter const &) { return {}; }
+        friend storage::storage_sid_impl_::bounds_type<data_store_t, integral_constant<int_t, 0>> sid_get_lower_bounds(
+            fortran_array_adapter const &) {
+            return {};
+        }
+        friend auto sid_get_upper_bounds(fortran_array_adapter const &obj) {
+            using res_t = storage::storage_sid_impl_::bounds_type<data_store_t, int_t>;
+            using generators_t =
+                meta::transform<storage::storage_sid_impl_::upper_bound_generator_f, get_keys<res_t>>;
+            return tuple_util::generate<generators_t, res_t>(obj.fortran_lengths());
+        }
+
       public:
         fortran_array_adapter(const bindgen_fortran_array_descriptor &descriptor) : m_descriptor(descriptor) {
             if (m_descriptor.rank != bindgen_view_rank::value)
@@ -64,20 +131,53 @@ namespace gridtools {
                                          "] != datastore-rank [" + std::to_string(bindgen_view_rank::value) + "]");
         }
 
-        using bindgen_view_rank = std::integral_constant<size_t, data_store_t::layout_t::unmasked_length>;
+        using bindgen_view_rank = std::integral_constant<size_t, layout_t::unmasked_length>;
         using bindgen_view_element_type = std::remove_pointer_t<data_ptr_t>;
         using bindgen_is_acc_present = bool_constant<true>;
 
         void transform_to(DataStorePtr const &dst) const {
             check_fortran_lengths(dst);
             interface::transform(
-                dst->get_target_ptr(), fortran_ptr(), dst->lengths(), dst->strides(), fortran_strides(dst));
+                dst->get_target_ptr(), fortran_ptr(), dst->lengths(), dst->strides(), fortran_strides());
         }
 
         void transform_from(DataStorePtr const &src) const {
             check_fortran_lengths(src);
             interface::transform(
-                fortran_ptr(), src->get_target_ptr(), src->lengths(), fortran_strides(src), src->strides());
+                fortran_ptr(), src->get_target_ptr(), src->lengths(), fortran_strides(), src->strides());
+        }
+
+        /**
+         * True if the Fortran array can be used in place of a data store: the storage has the Fortran order of the
+         * strides, the array is in the memory space of the storage and its address is aligned as required by the
+         * storage.
+         */
+        bool is_adoptable() const {
+            using traits_t = typename data_store_t::traits_t;
+            if (!has_fortran_layout())
+                return false;
+#ifdef __CUDACC__
+            if (is_gpu_ptr(fortran_ptr()) == storage::traits::is_host_referenceable<traits_t>)
+                return false;
+#endif
+            return reinterpret_cast<std::uintptr_t>(fortran_ptr()) % storage::traits::alignment<traits_t> == 0;
+        }
+
+        /**
+         * Calls fun with a SID of the Fortran array: the adapter itself if the array is adoptable, otherwise the data
+         * store returned by make_data_store, which is filled with the array before the call and copied back into it
+         * after the call.
+         */
+        template <class MakeDataStore, class Fun>
+        void adopt_or_transform(MakeDataStore &&make_data_store, Fun &&fun) const {
+            if (is_adoptable()) {
+                fun(*this);
+                return;
+            }
+            DataStorePtr ds = make_data_store();
+            transform_to(ds);
+            fun(ds);
+            transform_from(ds);
         }
     };
 } // namespace gridtools
@@ -10,46 +10,137 @@
 
 #pragma once
 
-#include <cassert>
-#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 
-#include "../../common/hypercube_iterator.hpp"
+#include "../../common/array.hpp"
+#include "../../common/integral_constant.hpp"
 #include "../../common/tuple_util.hpp"
 
 namespace gridtools {
     namespace impl {
+        namespace layout_transformation_omp_ {
+            /**
+             * Edge of the square tiles of the transposition: a tile row spans a few cache lines and the source and
+             * destination tiles fit together in the L1 cache.
+             */
+            template <class T>
+            constexpr std::ptrdiff_t tile_size() {
+                return sizeof(T) >= 32 ? 8 : sizeof(T) <= 4 ? 64 : 256 / sizeof(T);
+            }
+
+            template <size_t N, class Tup>
+            array<std::ptrdiff_t, N> to_array(Tup const &tup) {
+                array<std::ptrdiff_t, N> res;
+                size_t n = 0;
+                tuple_util::for_each([&](auto val) { res[n++] = val; }, tup);
+                return res;
+            }
+
+            /**
+             * The dimension with the smallest stride among the ones with more than one point, `skip` excluded.
+             */
+            template <size_t N>
+            size_t fastest_dim(
+                array<std::ptrdiff_t, N> const &sizes, array<std::ptrdiff_t, N> const &strides, size_t skip) {
+                size_t res = skip == 0 ? 1 : 0;
+                for (size_t d = 0; d != N; ++d)
+                    if (d != skip && sizes[d] > 1 &&
+                        (sizes[res] <= 1 || std::abs(strides[d]) < std::abs(strides[res])))
+                        res = d;
+                return res;
+            }
+
+            template <class T, class DstInnerStride>
+            void copy_tile(T *__restrict__ dst,
+                T const *__restrict__ src,
+                std::ptrdiff_t outer_size,
+                std::ptrdiff_t inner_size,
+                std::ptrdiff_t dst_outer_stride,
+                std::ptrdiff_t src_outer_stride,
+                DstInnerStride dst_inner_stride,
+                std::ptrdiff_t src_inner_stride) {
+                for (std::ptrdiff_t o = 0; o < outer_size; ++o) {
+                    T *__restrict__ dst_row = dst + o * dst_outer_stride;
+                    T const *__restrict__ src_row = src + o * src_outer_stride;
+#pragma omp simd
+                    for (std::ptrdiff_t i = 0; i < inner_size; ++i)
+                        dst_row[i * dst_inner_stride] = src_row[i * src_inner_stride];
+                }
+            }
+        } // namespace layout_transformation_omp_
+
+        /**
+         * Copies between two layouts of the same array as a tiled transposition: the innermost loop runs along the
+         * contiguous dimension of dst, the rows of a tile along the contiguous dimension of src, such that both sides
+         * are accessed by whole cache lines. All the tiles, of all the dimensions, are distributed over the OpenMP
+         * threads by a single parallel loop.
+         */
         template <class T, class Dims, class DstStrides, class SrcSrides>
         void transform_openmp_loop(
             T *dst, T const *__restrict__ src, Dims dims, DstStrides dst_strides, SrcSrides src_strides) {
+            using namespace layout_transformation_omp_;
+            constexpr size_t n_dims = tuple_util::size<Dims>::value;
+            constexpr std::ptrdiff_t tile = tile_size<T>();
 
-            auto omp_loop = [size_i = tuple_util::get<0>(dims),
-                                size_j = tuple_util::get<1>(dims),
-                                size_k = tuple_util::get<2>(dims),
-                                src_stride_i = tuple_util::get<0>(src_strides),
-                                src_stride_j = tuple_util::get<1>(src_strides),
-                                src_stride_k = tuple_util::get<2>(src_strides),
-                                dst_stride_i = tuple_util::get<0>(dst_strides),
-                                dst_stride_j = tuple_util::get<1>(dst_strides),
-                                dst_stride_k = tuple_util::get<2>(dst_strides)](T *dst, T const *__restrict__ src) {
-#pragma omp parallel for collapse(3)
-                for (int i = 0; i < size_i; ++i)
-                    for (int j = 0; j < size_j; ++j)
-                        for (int k = 0; k < size_k; ++k)
-                            dst[dst_stride_i * i + dst_stride_j * j + dst_stride_k * k] =
-                                src[src_stride_i * i + src_stride_j * j + src_stride_k * k];
-            };
-
-            auto offset = [](auto const &index, auto const &strides) {
-                size_t res = 0;
-                tuple_util::for_each([&res](auto i, auto stride) { res += i * stride; }, index, strides);
-                return res;
-            };
+            auto sizes = to_array<n_dims>(dims);
+            auto dst_s = to_array<n_dims>(dst_strides);
+            auto src_s = to_array<n_dims>(src_strides);
+
+            size_t inner = fastest_dim(sizes, dst_s, n_dims);
+            size_t outer = fastest_dim(sizes, src_s, inner);
 
-            auto &&extra_src_strides = tuple_util::drop_front<3>(std::move(src_strides));
-            auto &&extra_dst_strides = tuple_util::drop_front<3>(std::move(dst_strides));
+            // the blocks are decomposed with the inner tiles varying fastest, then the outer tiles and the single
+            // points of the other dimensions
+            array<size_t, n_dims> order;
+            array<std::ptrdiff_t, n_dims> blocks;
+            order[0] = inner;
+            order[1] = outer;
+            std::ptrdiff_t total = 1;
+            for (size_t d = 0, n = 2; d != n_dims; ++d) {
+                if (d != inner && d != outer)
+                    order[n++] = d;
+                blocks[d] = d == inner || d == outer ? (sizes[d] + tile - 1) / tile : sizes[d];
+                total *= blocks[d];
+            }
 
-            for (auto i : make_hypercube_view(tuple_util::drop_front<3>(dims)))
-                omp_loop(dst + offset(i, extra_dst_strides), src + offset(i, extra_src_strides));
+#pragma omp parallel for
+            for (std::ptrdiff_t b = 0; b < total; ++b) {
+                array<std::ptrdiff_t, n_dims> begin;
+                std::ptrdiff_t rest = b;
+                std::ptrdiff_t dst_offset = 0;
+                std::ptrdiff_t src_offset = 0;
+                for (size_t n = 0; n != n_dims; ++n) {
+                    size_t d = order[n];
+                    begin[d] = rest % blocks[d];
+                    rest /= blocks[d];
+                    if (n < 2)
+                        begin[d] *= tile;
+                    dst_offset += begin[d] * dst_s[d];
+                    src_offset += begin[d] * src_s[d];
+                }
+                std::ptrdiff_t outer_size = std::min(tile, sizes[outer] - begin[outer]);
+                std::ptrdiff_t inner_size = std::min(tile, sizes[inner] - begin[inner]);
+                if (dst_s[inner] == 1)
+                    copy_tile(dst + dst_offset,
+                        src + src_offset,
+                        outer_size,
+                        inner_size,
+                        dst_s[outer],
+                        src_s[outer],
+                        integral_constant<std::ptrdiff_t, 1>(),
+                        src_s[inner]);
+                else
+                    copy_tile(dst + dst_offset,
+                        src + src_offset,
+                        outer_size,
+                        inner_size,
+                        dst_s[outer],
+                        src_s[outer],
+                        dst_s[inner],
+                        src_s[inner]);
+            }
         }
     } // namespace impl
 } // namespace gridtools
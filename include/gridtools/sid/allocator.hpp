@@ -41,18 +41,26 @@
  *  API
  *  ---
  *
- *  The library provides two types that model the concept:
+ *  The library provides three types that model the concept:
  *    - `allocator`,
- *    - `cached_allocator`.
+ *    - `cached_allocator`,
+ *    - `arena_allocator`.
  *
- *  Both are templated with the functor that takes the size in bytes and returns `std::unique_ptr`
+ *  All are templated with the functor that takes the size in bytes and returns `std::unique_ptr`
  *
- *  There are also correspondent generators: `make_allocator` and `make_cached_allocator`.
+ *  There are also correspondent generators: `make_allocator`, `make_cached_allocator` and `make_arena_allocator`.
  *
  *  Semantics:
  *    - `allocator` keeps the resources that are allocated and releases them in dtor.
  *    - `cached_allocator` keeps resources during its lifetime. On dtor it stashes the resources in the internal static
  *      storage. The newly created instances of `cached_allocator` will attempt to reuse the stashed resources.
+ *    - `arena_allocator` carves all allocations out of a single slab. The buffers are page aligned and shifted by
+ *      multiples of the cache line size against each other to avoid 4K aliasing. On dtor the slab is stashed in the
+ *      internal static storage together with the total size that was requested. The next instance reuses the slab
+ *      or, if it was too small, replaces it by one that is large enough. Only if the slab is too small the
+ *      allocations fall back to single calls of the functor. `is_fresh(allocator, ptr)` tells if the memory
+ *      returned by `allocate` has been obtained from the functor during the lifetime of the allocator, that is if it
+ *      has not been used by a previous instance. For the other allocators `sid::is_fresh` is always true.
  *
  *  To make the simplest possible allocator one can do:
  *    `auto alloc = make_allocator(&std::make_unique<char[]>);`
@@ -95,6 +103,23 @@ namespace gridtools {
                     return {ptr.release(), {ptr.get_deleter(), stack}};
                 }
             };
+
+            constexpr size_t cache_line_size = 64;
+            constexpr size_t page_size = 4096;
+
+            /**
+             *  Offset of the buffer with the given index within an arena, `end` is the end of the previous buffer.
+             */
+            inline size_t arena_offset(size_t end, size_t index) {
+                return (end + page_size - 1) / page_size * page_size + index * cache_line_size % page_size;
+            }
+
+            template <class Ptr>
+            struct arena_slab {
+                Ptr m_ptr;
+                size_t m_capacity = 0;
+                size_t m_required = 0;
+            };
         } // namespace allocator_impl_
     }     // namespace sid
 } // namespace gridtools
@@ -124,7 +149,6 @@ namespace gridtools {
                 template <class LazyT>
                 friend auto allocate(allocator &self, LazyT, size_t size) {
                     using type = typename LazyT::type;
-                    auto ptr = self.m_impl(sizeof(type) * size);
                     self.m_buffers.push_back(self.m_impl(sizeof(type) * size));
                     return make_simple_ptr_holder(reinterpret_cast<type *>(self.m_buffers.back().get()));
                 }
@@ -136,6 +160,80 @@ namespace gridtools {
                 cached_allocator(Impl impl) : cached_allocator::allocator({std::move(impl)}) {}
             };
 
+            template <class Impl, class Ptr = decltype(std::declval<Impl const>()(size_t{}))>
+            class arena_allocator;
+
+            template <class Impl, class T, class Deleter>
+            class arena_allocator<Impl, std::unique_ptr<T, Deleter>> {
+                using ptr_t = std::unique_ptr<T, Deleter>;
+                using slab_t = allocator_impl_::arena_slab<ptr_t>;
+
+                static slab_t &stashed_slab() {
+                    static thread_local slab_t slab;
+                    return slab;
+                }
+
+                Impl m_impl;
+                ptr_t m_slab;
+                bool m_fresh_slab = false;
+                size_t m_capacity = 0;
+                size_t m_end = 0;
+                size_t m_count = 0;
+                std::vector<ptr_t> m_overflow;
+
+              public:
+                arena_allocator(Impl impl = {}) : m_impl(std::move(impl)) {
+                    auto &stashed = stashed_slab();
+                    if (stashed.m_required > stashed.m_capacity) {
+                        stashed.m_ptr.reset();
+                        stashed.m_ptr = m_impl(stashed.m_required);
+                        stashed.m_capacity = stashed.m_required;
+                        m_fresh_slab = true;
+                    }
+                    m_slab = std::move(stashed.m_ptr);
+                    m_capacity = m_slab ? stashed.m_capacity : 0;
+                    stashed.m_capacity = 0;
+                }
+
+                arena_allocator(arena_allocator &&other) noexcept
+                    : m_impl(std::move(other.m_impl)), m_slab(std::move(other.m_slab)),
+                      m_fresh_slab(other.m_fresh_slab), m_capacity(other.m_capacity), m_end(other.m_end),
+                      m_count(other.m_count), m_overflow(std::move(other.m_overflow)) {
+                    other.m_capacity = 0;
+                    other.m_end = 0;
+                }
+
+                arena_allocator &operator=(arena_allocator &&) = delete;
+
+                ~arena_allocator() {
+                    auto &stashed = stashed_slab();
+                    if (m_end > stashed.m_required)
+                        stashed.m_required = m_end;
+                    if (m_slab && m_capacity >= stashed.m_capacity) {
+                        stashed.m_ptr = std::move(m_slab);
+                        stashed.m_capacity = m_capacity;
+                    }
+                }
+
+                template <class LazyT>
+                friend auto allocate(arena_allocator &self, LazyT, size_t size) {
+                    using type = typename LazyT::type;
+                    size_t offset = allocator_impl_::arena_offset(self.m_end, self.m_count++);
+                    self.m_end = offset + sizeof(type) * size;
+                    if (self.m_end <= self.m_capacity)
+                        return make_simple_ptr_holder(
+                            reinterpret_cast<type *>(reinterpret_cast<char *>(self.m_slab.get()) + offset));
+                    self.m_overflow.push_back(self.m_impl(sizeof(type) * size));
+                    return make_simple_ptr_holder(reinterpret_cast<type *>(self.m_overflow.back().get()));
+                }
+
+                friend bool is_fresh(arena_allocator const &self, void const *ptr) {
+                    char const *slab = reinterpret_cast<char const *>(self.m_slab.get());
+                    char const *p = static_cast<char const *>(ptr);
+                    return self.m_fresh_slab || !slab || p < slab || p >= slab + self.m_capacity;
+                }
+            };
+
             template <class Impl>
             allocator<Impl> make_allocator(Impl impl) {
                 return {std::move(impl)};
@@ -145,6 +243,19 @@ namespace gridtools {
             cached_allocator<Impl> make_cached_allocator(Impl impl) {
                 return {std::move(impl)};
             }
+
+            template <class Impl>
+            arena_allocator<Impl> make_arena_allocator(Impl impl) {
+                return {std::move(impl)};
+            }
+
+            /**
+             *  Default for the allocators that do not reuse the memory of previous instances.
+             */
+            template <class Allocator>
+            bool is_fresh(Allocator const &, void const *) {
+                return true;
+            }
         }
     } // namespace sid
 } // namespace gridtools
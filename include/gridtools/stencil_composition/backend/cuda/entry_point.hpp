@@ -29,7 +29,7 @@
 #include "../../common/caches.hpp"
 #include "../../common/dim.hpp"
 #include "../../common/extent.hpp"
-#include "fill_flush.hpp"
+#include "../../core/fill_flush.hpp"
 #include "ij_cache.hpp"
 #include "k_cache.hpp"
 #include "launch_kernel.hpp"
@@ -242,10 +242,10 @@ namespace gridtools {
 
             template <class Spec, class Grid, class DataStores>
             friend void gridtools_backend_entry_point(backend, Spec, Grid const &grid, DataStores data_stores) {
-                using new_spec_t = fill_flush::transform_spec<Spec>;
+                using new_spec_t = core::fill_flush::transform_spec<Spec>;
                 using msses_t = be_api::make_fused_view<new_spec_t>;
-                backend::entry_point<msses_t>(
-                    grid, fill_flush::transform_data_stores<typename msses_t::plh_map_t>(std::move(data_stores)));
+                backend::entry_point<msses_t>(grid,
+                    core::fill_flush::transform_data_stores<typename msses_t::plh_map_t>(std::move(data_stores)));
             }
         };
     } // namespace cuda
@@ -9,9 +9,14 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <utility>
 
+#include "../../../common/cache_size.hpp"
 #include "../../../common/defs.hpp"
+#include "../../../common/functional.hpp"
 #include "../../../common/hymap.hpp"
 #include "../../../common/integral_constant.hpp"
 #include "../../../common/tuple_util.hpp"
@@ -21,35 +26,82 @@
 #include "../../../sid/composite.hpp"
 #include "../../../sid/concept.hpp"
 #include "../../be_api.hpp"
+#include "../../common/block_size_tuner.hpp"
 #include "../../common/dim.hpp"
+#include "../../core/fill_flush.hpp"
 #include "execinfo_mc.hpp"
+#include "ij_cache.hpp"
+#include "k_cache.hpp"
 #include "loops.hpp"
 #include "pos3.hpp"
+#include "schedule.hpp"
 #include "tmp_storage_sid.hpp"
 
 namespace gridtools {
     namespace mc {
-        struct backend {
-            template <class Spec, class Grid, class DataStores>
-            friend void gridtools_backend_entry_point(
-                backend, Spec, Grid const &grid, DataStores external_data_stores) {
-                using stages_t = be_api::make_split_view<Spec>;
+        namespace entry_point_impl_ {
+            template <class Matrix>
+            using make_mss_stages = meta::transform<be_api::make_split_view_item, be_api::fuse_stage_rows<Matrix>>;
+
+            /**
+             * @brief Does the setup of the computation and returns a callable that executes it.
+             *
+             * The temporaries are allocated from `alloc`, which has to outlive the returned callable.
+             */
+            template <class Schedule, class Spec, class Grid, class DataStores>
+            auto make_run(Spec,
+                Grid const &grid,
+                DataStores external_data_stores,
+                int_t i_block_size,
+                int_t j_block_size,
+                tmp_allocator_mc &alloc) {
+                using spec_t = core::fill_flush::transform_spec<Spec>;
+                using msses_t = meta::transform<make_mss_stages, spec_t>;
+                using stages_t = be_api::make_split_view<spec_t>;
                 using all_parrallel_t =
                     typename meta::all_of<be_api::is_parallel, meta::transform<be_api::get_execution, stages_t>>::type;
+                using k_cached_keys_t = k_cached_keys<stages_t>;
 
-                tmp_allocator_mc alloc;
+                // temporaries that are k-cached everywhere do not need any storage
+                using tmp_plh_map_t = be_api::remove_caches_from_plh_map<
+                    meta::filter<meta::not_<key_in_f<k_cached_keys_t>::template apply>::template apply,
+                        typename stages_t::tmp_plh_map_t>>;
+                using tmp_buffers_t =
+                    be_api::tmp_buffers<stages_t, tmp_plh_map_t, ij_plane_buffer_key_f<msses_t>::template apply>;
+                using ij_planes_t =
+                    meta::filter<is_ij_plane_f<msses_t>::template apply, meta::transform<meta::first, tmp_buffers_t>>;
+
+                if (!meta::is_empty<ij_planes_t>::value && i_block_size <= 0 && j_block_size <= 0) {
+                    execinfo_mc default_info(grid, Schedule::blocks_per_thread);
+                    i_block_size = default_info.i_block_size();
+                    j_block_size = default_info.j_block_size();
+                    fit_block_to_cache(i_block_size,
+                        j_block_size,
+                        [](int_t i_size, int_t j_size) {
+                            std::size_t res = 0;
+                            tuple_util::for_each(
+                                [&](auto info) {
+                                    using extent_t = typename decltype(info)::extent_t;
+                                    res += sizeof(typename decltype(info)::data_t) *
+                                           extent_t::extend(dim::i(), i_size) * extent_t::extend(dim::j(), j_size);
+                                },
+                                meta::rename<tuple, ij_planes_t>());
+                            return res;
+                        },
+                        l2_cache_size() / 2);
+                }
 
-                execinfo_mc info(grid);
+                execinfo_mc info(grid, Schedule::blocks_per_thread, i_block_size, j_block_size);
 
-                using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-                auto temporaries = be_api::make_data_stores(tmp_plh_map_t(),
+                auto temporaries = be_api::make_buffer_data_stores(tmp_buffers_t(),
                     [&alloc,
                         block_size =
                             make_pos3((size_t)info.i_block_size(), (size_t)info.j_block_size(), (size_t)grid.k_size())](
                         auto info) {
                         return make_tmp_storage_mc<decltype(info.data()),
                             decltype(info.extent()),
-                            all_parrallel_t::value>(alloc, block_size);
+                            all_parrallel_t::value || is_ij_plane<msses_t, decltype(info.plh())>::value>(
+                            alloc, block_size);
                     });
 
                 auto blocked_externals = tuple_util::transform(
@@ -57,28 +109,101 @@ namespace gridtools {
                          info.i_block_size(), info.j_block_size())](auto &&data_store) {
                         return sid::block(std::forward<decltype(data_store)>(data_store), block_size);
                     },
-                    std::move(external_data_stores));
+                    core::fill_flush::transform_data_stores<typename stages_t::plh_map_t>(
+                        std::move(external_data_stores)));
 
                 auto data_stores = hymap::concat(std::move(blocked_externals), std::move(temporaries));
 
-                auto loops = tuple_util::transform(
-                    [&](auto stage) {
-                        using stage_t = decltype(stage);
-                        auto k_sizes = tuple_util::transform(
-                            [&](auto cell) { return grid.k_size(cell.interval()); }, stage_t::cells());
-
-                        using plh_map_t = typename stage_t::plh_map_t;
-                        using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
-                        auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
-                            [&](auto info) {
+                auto make_stage_loop = [&](auto stage, auto is_parallel) {
+                    using stage_t = decltype(stage);
+                    auto k_sizes = tuple_util::transform(
+                        [&](auto cell) { return grid.k_size(cell.interval()); }, stage_t::cells());
+
+                    using plh_map_t = typename stage_t::plh_map_t;
+                    using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
+                    auto k_caches = make_k_caches<k_cached_keys_t>(
+                        stage_t::plh_map(), alloc, stage_t::extent_t::extend(dim::i(), info.i_block_size()));
+                    auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
+                        overload([&](std::true_type, auto) { return k_caches.sid(); },
+                            [&](std::false_type, auto info) {
                                 return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
-                            },
-                            stage_t::plh_map()));
-                        return make_loop<stage_t>(all_parrallel_t(), grid, std::move(composite), std::move(k_sizes));
+                            }),
+                        meta::transform<key_in_f<k_cached_keys_t>::template apply, plh_map_t>(),
+                        stage_t::plh_map()));
+                    return make_loop<stage_t>(
+                        is_parallel, grid, std::move(composite), std::move(k_sizes), std::move(k_caches));
+                };
+
+                auto loops = tuple_util::transform(
+                    [&](auto mss) {
+                        using mss_t = decltype(mss);
+                        using is_parallel_t =
+                            typename be_api::is_parallel<typename meta::first<mss_t>::execution_t>::type;
+                        return make_mss_loops(is_parallel_t(),
+                            tuple_util::transform([&](auto stage) { return make_stage_loop(stage, is_parallel_t()); },
+                                meta::rename<tuple, mss_t>()));
                     },
-                    meta::rename<tuple, stages_t>());
+                    meta::rename<tuple, msses_t>());
+
+                return [grid, info, loops = std::move(loops)] {
+                    run_loops(Schedule(), all_parrallel_t(), grid, info, loops);
+                };
+            }
 
-                run_loops(all_parrallel_t(), grid, std::move(loops));
+            template <class Schedule, class Spec, class Grid, class DataStores>
+            void run(Spec, Grid const &grid, DataStores external_data_stores, int_t i_block_size, int_t j_block_size) {
+                tmp_allocator_mc alloc;
+                make_run<Schedule>(Spec(), grid, std::move(external_data_stores), i_block_size, j_block_size, alloc)();
+            }
+        } // namespace entry_point_impl_
+
+        /**
+         * @brief Backend for modern CPUs.
+         *
+         * The block sizes along i and j are computed from the number of threads, unless set explicitly to positive
+         * values or chosen by a `block_size_tuner`.
+         *
+         * @tparam Schedule Policy for distributing the blocks among the threads, `static_schedule` or
+         * `dynamic_schedule<BlocksPerThread>`.
+         */
+        template <class Schedule = static_schedule>
+        struct backend {
+            int_t i_block_size = 0;
+            int_t j_block_size = 0;
+            block_size_tuner *tuner = nullptr;
+
+            template <class Spec, class Grid, class DataStores>
+            friend void gridtools_backend_entry_point(
+                backend const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+                if (be.tuner)
+                    be.tuner->run(Spec(), grid, [&](int_t i_block_size, int_t j_block_size) {
+                        entry_point_impl_::run<Schedule>(
+                            Spec(), grid, std::move(external_data_stores), i_block_size, j_block_size);
+                    });
+                else
+                    entry_point_impl_::run<Schedule>(
+                        Spec(), grid, std::move(external_data_stores), be.i_block_size, be.j_block_size);
+            }
+
+            /**
+             * @brief Prepared computation: temporaries, blocking and loops are set up once. With a `block_size_tuner`
+             * the setup is repeated on each call, as the block sizes may change between calls.
+             */
+            template <class Spec, class Grid, class DataStores>
+            friend std::function<void()> gridtools_backend_make_computation(
+                backend const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+                if (be.tuner)
+                    return [be, grid, external_data_stores = std::move(external_data_stores)] {
+                        gridtools_backend_entry_point(be, Spec(), grid, external_data_stores);
+                    };
+                auto alloc = std::make_shared<tmp_allocator_mc>();
+                return [alloc,
+                           run = entry_point_impl_::make_run<Schedule>(Spec(),
+                               grid,
+                               std::move(external_data_stores),
+                               be.i_block_size,
+                               be.j_block_size,
+                               *alloc)] { run(); };
             }
         };
     } // namespace mc
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "../../../common/defs.hpp"
 #include "../../../common/host_device.hpp"
 #include "../../../common/omp.hpp"
@@ -53,17 +55,24 @@ namespace gridtools {
             }
 
           public:
+            /**
+             * @brief Splits the domain into (at most) `blocks_per_thread` blocks per thread.
+             *
+             * Positive `i_block_size` or `j_block_size` values override the block sizes computed by the heuristic.
+             */
             template <class Grid>
-            GT_FORCE_INLINE execinfo_mc(const Grid &grid) : m_i_grid_size(grid.i_size()), m_j_grid_size(grid.j_size()) {
-                int_t threads = omp_get_max_threads();
+            GT_FORCE_INLINE execinfo_mc(
+                const Grid &grid, int_t blocks_per_thread = 1, int_t i_block_size = 0, int_t j_block_size = 0)
+                : m_i_grid_size(grid.i_size()), m_j_grid_size(grid.j_size()) {
+                int_t blocks = omp_get_max_threads() * blocks_per_thread;
 
-                // if domain is large enough (relative to the number of threads),
+                // if domain is large enough (relative to the number of blocks),
                 // we split only along j-axis (for prefetching reasons)
                 // for smaller domains we also split along i-axis
-                m_j_block_size = (m_j_grid_size + threads - 1) / threads;
+                m_j_block_size = j_block_size > 0 ? j_block_size : (m_j_grid_size + blocks - 1) / blocks;
                 m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
-                int_t max_i_blocks = threads / m_j_blocks;
-                m_i_block_size = (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
+                int_t max_i_blocks = std::max(blocks / m_j_blocks, int_t(1));
+                m_i_block_size = i_block_size > 0 ? i_block_size : (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
                 m_i_blocks = (m_i_grid_size + m_i_block_size - 1) / m_i_block_size;
 
                 assert(m_i_block_size > 0 && m_j_block_size > 0);
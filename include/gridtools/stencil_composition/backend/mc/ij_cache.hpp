@@ -0,0 +1,123 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/integral_constant.hpp"
+#include "../../../meta.hpp"
+#include "../../be_api.hpp"
+#include "../../common/caches.hpp"
+
+/**
+ *  ij-caches of the mc backend.
+ *
+ *  The mc backend executes parallel multi-stage computations level by level within a block. A temporary that is
+ *  ij-cached and accessed only within a single parallel multi-stage computation is thus stored as a single plane of the
+ *  block per thread, which is re-used for all levels. To keep these planes cache resident, the default block size is
+ *  reduced until the planes of a block fit into a fraction of the L2 cache.
+ */
+namespace gridtools {
+    namespace mc {
+        namespace ij_cache_impl_ {
+            template <class PlhInfo>
+            using is_ij_cached = std::is_same<typename PlhInfo::caches_t, meta::list<cache_type::ij>>;
+
+            template <class Plh>
+            struct has_plh_f {
+                template <class PlhInfo>
+                using apply = std::is_same<typename PlhInfo::plh_t, Plh>;
+            };
+
+            template <class Plh>
+            struct stage_has_plh_f {
+                template <class Stage>
+                using apply = meta::any_of<has_plh_f<Plh>::template apply, typename Stage::plh_map_t>;
+            };
+
+            template <class Plh>
+            struct mss_has_plh_f {
+                template <class Mss>
+                using apply = meta::any_of<stage_has_plh_f<Plh>::template apply, Mss>;
+            };
+
+            template <class Plh>
+            struct is_ij_cached_in_stage_f {
+                template <class Stage>
+                using apply =
+                    meta::all_of<is_ij_cached, meta::filter<has_plh_f<Plh>::template apply, typename Stage::plh_map_t>>;
+            };
+
+            template <class Mss>
+            using is_parallel_mss = be_api::is_parallel<typename meta::first<Mss>::execution_t>;
+
+            template <class Plh, class Msses>
+            struct is_ij_plane_impl : std::false_type {};
+
+            template <class Plh, class Mss>
+            struct is_ij_plane_impl<Plh, meta::list<Mss>>
+                : bool_constant<is_parallel_mss<Mss>::value &&
+                                meta::all_of<is_ij_cached_in_stage_f<Plh>::template apply, Mss>::value> {};
+
+            /**
+             *  True if the temporary `Plh` can be stored as a single plane per thread: it is accessed within a single
+             *  parallel multi-stage computation only and is ij-cached in all stages that access it.
+             *
+             *  @tparam Msses List of multi-stage computations, each a list of stages.
+             */
+            template <class Msses, class Plh>
+            using is_ij_plane = is_ij_plane_impl<Plh,
+                meta::filter<mss_has_plh_f<Plh>::template apply, meta::rename<meta::list, Msses>>>;
+
+            template <class Msses>
+            struct is_ij_plane_f {
+                template <class PlhInfo>
+                using apply = is_ij_plane<Msses, typename PlhInfo::plh_t>;
+            };
+
+            /**
+             *  Temporaries stored as planes can share a buffer with other planes only.
+             */
+            template <class Msses>
+            struct ij_plane_buffer_key_f {
+                template <class PlhInfo>
+                using apply =
+                    meta::list<be_api::default_buffer_key<PlhInfo>, is_ij_plane<Msses, typename PlhInfo::plh_t>>;
+            };
+
+            /**
+             * @brief Reduces the given block sizes until `bytes(i_block_size, j_block_size)` does not exceed
+             * `cache_size`.
+             *
+             * The j block size is reduced first, keeping long contiguous rows for vectorization and prefetching.
+             */
+            template <class Bytes>
+            void fit_block_to_cache(int_t &i_block_size, int_t &j_block_size, Bytes &&bytes, std::size_t cache_size) {
+                constexpr int_t min_i_block_size = 32;
+                constexpr int_t min_j_block_size = 8;
+                while (bytes(i_block_size, j_block_size) > cache_size) {
+                    if (j_block_size > min_j_block_size || (i_block_size <= min_i_block_size && j_block_size > 1))
+                        j_block_size = (j_block_size + 1) / 2;
+                    else if (i_block_size > min_i_block_size)
+                        i_block_size = (i_block_size + 1) / 2;
+                    else
+                        break;
+                }
+            }
+        } // namespace ij_cache_impl_
+
+        using ij_cache_impl_::fit_block_to_cache;
+        using ij_cache_impl_::ij_plane_buffer_key_f;
+        using ij_cache_impl_::is_ij_plane;
+        using ij_cache_impl_::is_ij_plane_f;
+    } // namespace mc
+} // namespace gridtools
@@ -0,0 +1,178 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/hymap.hpp"
+#include "../../../common/integral_constant.hpp"
+#include "../../../common/omp.hpp"
+#include "../../../common/tuple_util.hpp"
+#include "../../../meta.hpp"
+#include "../../../sid/concept.hpp"
+#include "../../be_api.hpp"
+#include "../../common/caches.hpp"
+#include "../../common/dim.hpp"
+#include "tmp_storage_sid.hpp"
+
+/**
+ *  k-caches for the k-serial loops of the mc backend.
+ *
+ *  A k-cached placeholder is stored in a small per thread buffer that holds a window of `kplus - kminus + 1` levels
+ *  of a full row of the i block. The window is kept in place and the values are moved by one level after each level,
+ *  thus cached values stay in the L1 cache and are never written to main memory. Reading from and writing to the
+ *  original data is done by the stages added by `core::fill_flush`.
+ *
+ *  As the data of a cached placeholder lives only during the k loop of a single stage, a placeholder is cached only
+ *  if it is accessed by exactly one k-serial stage. Otherwise the original data is used.
+ */
+namespace gridtools {
+    namespace mc {
+        namespace k_cache_impl_ {
+            template <class PlhInfo>
+            using is_k_cached = std::is_same<typename PlhInfo::caches_t, meta::list<cache_type::k>>;
+
+            template <class Stage>
+            using stage_keys = meta::transform<be_api::get_key, typename Stage::plh_map_t>;
+
+            template <class Stage>
+            using stage_k_cached_keys = meta::if_<be_api::is_parallel<typename Stage::execution_t>,
+                meta::list<>,
+                meta::transform<be_api::get_key, meta::filter<is_k_cached, typename Stage::plh_map_t>>>;
+
+            template <class Keys>
+            struct is_unique_f {
+                template <class Key, class Found = meta::filter<meta::curry<std::is_same, Key>::template apply, Keys>>
+                using apply = bool_constant<meta::length<Found>::value == 1>;
+            };
+
+            template <class Stages,
+                class StageList = meta::rename<meta::list, Stages>,
+                class AllKeys = meta::flatten<meta::transform<stage_keys, StageList>>>
+            using k_cached_keys = meta::filter<is_unique_f<AllKeys>::template apply,
+                meta::flatten<meta::transform<stage_k_cached_keys, StageList>>>;
+
+            template <class Keys>
+            struct key_in_f {
+                template <class PlhInfo>
+                using apply = meta::st_contains<Keys, typename PlhInfo::key_t>;
+            };
+
+            struct fake {
+                fake operator()() const { return {}; }
+                fake operator*() const;
+            };
+            fake sid_get_ptr_diff(fake);
+            inline fake operator+(fake, fake) { return {}; }
+
+            struct strides_kind;
+
+            /**
+             *  The sid that represents the k-caches in the composite of a stage. It provides the strides only, the
+             *  pointers are taken from the per thread buffers.
+             */
+            struct k_cache_sid {
+                int_t m_k_stride;
+            };
+            fake sid_get_ptr_diff(k_cache_sid);
+            inline fake sid_get_origin(k_cache_sid const &) { return {}; }
+            inline hymap::keys<dim::i, dim::k>::values<integral_constant<int_t, 1>, int_t> sid_get_strides(
+                k_cache_sid const &obj) {
+                return {integral_constant<int_t, 1>(), obj.m_k_stride};
+            }
+            strides_kind sid_get_strides_kind(k_cache_sid const &);
+
+            template <class T>
+            GT_FORCE_INLINE void copy_row(T const *src, T *dst, int_t size) {
+#ifdef NDEBUG
+#pragma omp simd
+#endif
+                for (int_t i = 0; i < size; ++i)
+                    dst[i] = src[i];
+            }
+
+            template <class T, int_t Minus, int_t Plus>
+            struct buffer {
+                T *m_data;
+                int_t m_k_stride;
+                int_t m_thread_stride;
+
+                T *ptr() const { return m_data + omp_get_thread_num() * m_thread_stride - Minus * m_k_stride; }
+
+                template <class Step, std::enable_if_t<Step::value == 1, int> = 0>
+                GT_FORCE_INLINE void slide(Step, T *ptr, int_t i_size) const {
+                    for (int_t k = Minus; k < Plus; ++k)
+                        copy_row(ptr + (k + 1) * m_k_stride, ptr + k * m_k_stride, i_size);
+                }
+
+                template <class Step, std::enable_if_t<Step::value == -1, int> = 0>
+                GT_FORCE_INLINE void slide(Step, T *ptr, int_t i_size) const {
+                    for (int_t k = Plus; k > Minus; --k)
+                        copy_row(ptr + (k - 1) * m_k_stride, ptr + k * m_k_stride, i_size);
+                }
+            };
+
+            template <class Buffers>
+            class k_caches {
+                int_t m_k_stride;
+                Buffers m_buffers;
+
+              public:
+                k_caches(int_t k_stride, Buffers buffers) : m_k_stride(k_stride), m_buffers(std::move(buffers)) {}
+
+                k_cache_sid sid() const { return {m_k_stride}; }
+
+                /**
+                 * @brief Pointers to the current level of the buffers of the calling thread.
+                 */
+                auto ptrs() const {
+                    return tuple_util::transform([](auto const &buffer) { return buffer.ptr(); }, m_buffers);
+                }
+
+                /**
+                 * @brief Moves the cached values by one level, such that the window follows the k loop.
+                 */
+                template <class Step, class Ptrs>
+                GT_FORCE_INLINE void slide(Step step, Ptrs const &ptrs, int_t i_size) const {
+                    tuple_util::for_each(
+                        [&](auto const &buffer, auto ptr) { buffer.slide(step, ptr, i_size); }, m_buffers, ptrs);
+                }
+            };
+
+            template <class Keys, class PlhMap, class Allocator>
+            auto make_k_caches(PlhMap, Allocator &allocator, int_t i_size) {
+                using plh_map_t = meta::filter<key_in_f<Keys>::template apply, PlhMap>;
+                // a multiple of 16 elements keeps all rows cache line aligned for 4 and 8 byte types
+                int_t k_stride = (i_size + 15) / 16 * 16;
+                auto buffers = tuple_util::transform(
+                    [&](auto info) {
+                        using info_t = decltype(info);
+                        using data_t = std::remove_const_t<typename info_t::data_t>;
+                        using extent_t = typename info_t::extent_t;
+                        constexpr int_t minus = extent_t::kminus::value;
+                        constexpr int_t plus = extent_t::kplus::value;
+                        int_t thread_stride = _impl_tmp_mc::pad<data_t>((plus - minus + 1) * k_stride);
+                        auto ptr_holder = allocate(
+                            allocator, meta::lazy::id<data_t>(), (std::size_t)thread_stride * omp_get_max_threads());
+                        return buffer<data_t, minus, plus>{ptr_holder(), k_stride, thread_stride};
+                    },
+                    hymap::from_keys_values<meta::transform<be_api::get_key, plh_map_t>, plh_map_t>());
+                return k_caches<decltype(buffers)>(k_stride, std::move(buffers));
+            }
+        } // namespace k_cache_impl_
+
+        using k_cache_impl_::is_k_cached;
+        using k_cache_impl_::k_cached_keys;
+        using k_cache_impl_::key_in_f;
+        using k_cache_impl_::make_k_caches;
+    } // namespace mc
+} // namespace gridtools
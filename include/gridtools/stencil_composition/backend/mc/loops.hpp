@@ -14,12 +14,14 @@
 
 #include "../../../common/defs.hpp"
 #include "../../../common/generic_metafunctions/for_each.hpp"
+#include "../../../common/hymap.hpp"
 #include "../../../common/omp.hpp"
 #include "../../../common/tuple_util.hpp"
 #include "../../../meta.hpp"
 #include "../../../sid/concept.hpp"
 #include "../../common/dim.hpp"
 #include "execinfo_mc.hpp"
+#include "schedule.hpp"
 
 namespace gridtools {
     namespace mc {
@@ -41,28 +43,62 @@ namespace gridtools {
                 sid::shift(ptr, sid::get_stride<dim::i>(strides), -size);
             }
 
-            template <class Ptr, class Strides>
+            template <class Stage,
+                class CachePtrs,
+                class Ptr,
+                class Strides,
+                std::enable_if_t<tuple_util::size<CachePtrs>::value == 0, int> = 0>
+            GT_FORCE_INLINE void i_loop(int_t size, Stage stage, CachePtrs const &, Ptr &ptr, Strides const &strides) {
+                i_loop(size, stage, ptr, strides);
+            }
+
+            template <class Stage,
+                class CachePtrs,
+                class Ptr,
+                class Strides,
+                std::enable_if_t<tuple_util::size<CachePtrs>::value != 0, int> = 0>
+            GT_FORCE_INLINE void i_loop(
+                int_t size, Stage stage, CachePtrs const &cache_ptrs, Ptr const &ptr, Strides const &strides) {
+                // k-cache pointers are not part of the composite, they are merged in and shifted along i separately
+                auto mixed_ptr = hymap::merge(cache_ptrs, ptr);
+#ifdef NDEBUG
+#pragma ivdep
+#pragma omp simd
+#endif
+                for (int_t i = 0; i < size; ++i) {
+                    using namespace literals;
+                    stage(mixed_ptr, strides);
+                    sid::shift(mixed_ptr.secondary(), sid::get_stride<dim::i>(strides), 1_c);
+                    tuple_util::for_each([](auto &cache_ptr) { ++cache_ptr; }, mixed_ptr.primary());
+                }
+            }
+
+            template <class Ptr, class Strides, class KCaches, class CachePtrs>
             struct k_i_loops_f {
                 int_t m_i_size;
                 Ptr &m_ptr;
                 Strides const &m_strides;
+                KCaches const &m_k_caches;
+                CachePtrs const &m_cache_ptrs;
 
                 template <class Cell, class KSize>
                 GT_FORCE_INLINE void operator()(Cell cell, KSize k_size) const {
                     for (int_t k = 0; k < k_size; ++k) {
-                        i_loop(m_i_size, cell, m_ptr, m_strides);
+                        i_loop(m_i_size, cell, m_cache_ptrs, m_ptr, m_strides);
                         cell.inc_k(m_ptr, m_strides);
+                        m_k_caches.slide(cell.k_step(), m_cache_ptrs, m_i_size);
                     }
                 }
             };
 
-            template <class Ptr, class Strides>
-            GT_FORCE_INLINE k_i_loops_f<Ptr, Strides> make_k_i_loops(int_t i_size, Ptr &ptr, Strides const &strides) {
-                return {i_size, ptr, strides};
+            template <class Ptr, class Strides, class KCaches, class CachePtrs>
+            GT_FORCE_INLINE k_i_loops_f<Ptr, Strides, KCaches, CachePtrs> make_k_i_loops(
+                int_t i_size, Ptr &ptr, Strides const &strides, KCaches const &k_caches, CachePtrs const &cache_ptrs) {
+                return {i_size, ptr, strides, k_caches, cache_ptrs};
             }
 
-            template <class Stage, class Grid, class Composite, class KSizes>
-            auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes) {
+            template <class Stage, class Grid, class Composite, class KSizes, class KCaches>
+            auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes, KCaches) {
                 using extent_t = typename Stage::extent_t;
                 using ptr_diff_t = sid::ptr_diff_type<Composite>;
                 auto strides = sid::get_strides(composite);
@@ -99,24 +135,64 @@ namespace gridtools {
                 };
             }
 
-            template <class Grid, class Loops>
-            void run_loops(std::true_type, Grid const &grid, Loops loops) {
-                execinfo_mc info(grid);
+            /**
+             *  The loops of the stages of a multi-stage computation.
+             */
+            template <class IsParallel, class Loops>
+            struct mss_loops {
+                Loops m_loops;
+            };
+
+            template <class IsParallel, class Loops>
+            mss_loops<IsParallel, Loops> make_mss_loops(IsParallel, Loops loops) {
+                return {std::move(loops)};
+            }
+
+            // parallel multi-stage computations are executed level by level within a block, such that ij-cached
+            // temporaries need to hold a single level only
+            template <class Loops>
+            void run_block(mss_loops<std::true_type, Loops> const &mss,
+                execinfo_mc const &info,
+                int_t i_block,
+                int_t j_block,
+                int_t k_size) {
+                for (int_t k = 0; k < k_size; ++k) {
+                    auto block = info.block(i_block, j_block, k);
+                    tuple_util::for_each([&](auto const &loop) { loop(block); }, mss.m_loops);
+                }
+            }
+
+            template <class Loops>
+            void run_block(mss_loops<std::false_type, Loops> const &mss,
+                execinfo_mc const &info,
+                int_t i_block,
+                int_t j_block,
+                int_t) {
+                auto block = info.block(i_block, j_block);
+                tuple_util::for_each([&](auto const &loop) { loop(block); }, mss.m_loops);
+            }
+
+            template <class Schedule, class Grid, class Loops>
+            void run_loops(
+                Schedule schedule, std::true_type, Grid const &grid, execinfo_mc const &info, Loops const &loops) {
                 int_t i_blocks = info.i_blocks();
-                int_t j_blocks = info.j_blocks();
                 int_t k_size = grid.k_size();
-#pragma omp parallel for collapse(3)
-                for (int_t j = 0; j < j_blocks; ++j) {
-                    for (int_t k = 0; k < k_size; ++k) {
-                        for (int_t i = 0; i < i_blocks; ++i) {
-                            tuple_util::for_each([block = info.block(i, j, k)](auto &&loop) { loop(block); }, loops);
-                        }
-                    }
-                }
+                // iteration order: j (outermost), k, i (innermost)
+                parallel_for(schedule, info.j_blocks() * k_size * i_blocks, [&](int_t index) {
+                    int_t i = index % i_blocks;
+                    int_t k = index / i_blocks % k_size;
+                    int_t j = index / i_blocks / k_size;
+                    auto block = info.block(i, j, k);
+                    tuple_util::for_each(
+                        [&](auto const &mss) {
+                            tuple_util::for_each([&](auto const &loop) { loop(block); }, mss.m_loops);
+                        },
+                        loops);
+                });
             }
 
-            template <class Stage, class Grid, class Composite, class KSizes>
-            auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes) {
+            template <class Stage, class Grid, class Composite, class KSizes, class KCaches>
+            auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes, KCaches k_caches) {
                 using extent_t = typename Stage::extent_t;
                 using ptr_diff_t = sid::ptr_diff_type<Composite>;
 
@@ -130,7 +206,8 @@ namespace gridtools {
                 return [origin = sid::get_origin(composite) + offset,
                            strides = std::move(strides),
                            k_shift_back = -grid.k_size(Stage::interval()) * Stage::k_step(),
-                           k_sizes = std::move(k_sizes)](execinfo_block_kserial_mc const &info) {
+                           k_sizes = std::move(k_sizes),
+                           k_caches = std::move(k_caches)](execinfo_block_kserial_mc const &info) {
                     sid::ptr_diff_type<Composite> offset{};
                     sid::shift(offset, sid::get_stride<dim::thread>(strides), omp_get_thread_num());
                     sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), info.i_block);
@@ -140,7 +217,8 @@ namespace gridtools {
                     int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
                     int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
 
-                    auto k_i_loops = make_k_i_loops(i_size, ptr, strides);
+                    auto cache_ptrs = k_caches.ptrs();
+                    auto k_i_loops = make_k_i_loops(i_size, ptr, strides, k_caches, cache_ptrs);
                     for (int_t j = 0; j < j_size; ++j) {
                         using namespace literals;
                         tuple_util::for_each(k_i_loops, Stage::cells(), k_sizes);
@@ -150,20 +228,21 @@ namespace gridtools {
                 };
             }
 
-            template <class Grid, class Loops>
-            void run_loops(std::false_type, Grid const &grid, Loops loops) {
-                execinfo_mc info(grid);
+            template <class Schedule, class Grid, class Loops>
+            void run_loops(
+                Schedule schedule, std::false_type, Grid const &grid, execinfo_mc const &info, Loops const &loops) {
                 int_t i_blocks = info.i_blocks();
-                int_t j_blocks = info.j_blocks();
-#pragma omp parallel for collapse(2)
-                for (int_t j = 0; j < j_blocks; ++j) {
-                    for (int_t i = 0; i < i_blocks; ++i) {
-                        tuple_util::for_each([block = info.block(i, j)](auto &&loop) { loop(block); }, loops);
-                    }
-                }
+                int_t k_size = grid.k_size();
+                // iteration order: j (outermost), i (innermost)
+                parallel_for(schedule, info.j_blocks() * i_blocks, [&](int_t index) {
+                    int_t i = index % i_blocks;
+                    int_t j = index / i_blocks;
+                    tuple_util::for_each([&](auto const &mss) { run_block(mss, info, i, j, k_size); }, loops);
+                });
             }
         } // namespace loops_impl_
         using loops_impl_::make_loop;
+        using loops_impl_::make_mss_loops;
         using loops_impl_::run_loops;
     } // namespace mc
 } // namespace gridtools
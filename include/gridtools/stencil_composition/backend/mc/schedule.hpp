@@ -0,0 +1,62 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "../../../common/defs.hpp"
+#include "../../../common/host_device.hpp"
+
+namespace gridtools {
+    namespace mc {
+        /**
+         * @brief Static scheduling policy: the domain is split into (at most) one block per thread, blocks are
+         * assigned to threads in advance.
+         *
+         * Best choice for balanced workloads as the blocks are as large as possible.
+         */
+        struct static_schedule {
+            static constexpr int_t blocks_per_thread = 1;
+        };
+
+        /**
+         * @brief Dynamic scheduling policy: the domain is over-decomposed into `BlocksPerThread` blocks per thread,
+         * which are handed out to the threads on demand.
+         *
+         * Useful if the work per block is unbalanced (e.g. due to uneven vertical intervals) or if threads are slowed
+         * down irregularly (e.g. by co-located processes), as fast threads can process additional blocks.
+         */
+        template <int_t BlocksPerThread = 4>
+        struct dynamic_schedule {
+            static_assert(BlocksPerThread > 0, "number of blocks per thread must be positive");
+            static constexpr int_t blocks_per_thread = BlocksPerThread;
+        };
+
+        /**
+         * @brief Calls `fun(index)` for all indices in the range [0, size) in parallel, blocks are scheduled
+         * statically.
+         */
+        template <class Fun>
+        void parallel_for(static_schedule, int_t size, Fun &&fun) {
+#pragma omp parallel for schedule(static)
+            for (int_t index = 0; index < size; ++index)
+                fun(index);
+        }
+
+        /**
+         * @brief Calls `fun(index)` for all indices in the range [0, size) in parallel, blocks are scheduled
+         * dynamically.
+         */
+        template <int_t BlocksPerThread, class Fun>
+        void parallel_for(dynamic_schedule<BlocksPerThread>, int_t size, Fun &&fun) {
+#pragma omp parallel for schedule(dynamic)
+            for (int_t index = 0; index < size; ++index)
+                fun(index);
+        }
+    } // namespace mc
+} // namespace gridtools
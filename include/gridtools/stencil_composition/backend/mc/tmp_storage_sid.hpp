@@ -13,6 +13,7 @@
 
 #include "../../../common/hugepage_alloc.hpp"
 #include "../../../common/hymap.hpp"
+#include "../../../common/numa.hpp"
 #include "../../../common/omp.hpp"
 #include "../../../sid/allocator.hpp"
 #include "../../../sid/concept.hpp"
@@ -51,25 +52,28 @@ namespace gridtools {
             }
 
             /**
-             * @brief Size of the full allocation of a temporary buffer (in number of elements).
+             * @brief Size of the memory region of a single thread (in number of elements). Padded to a multiple of the
+             * page size if possible, such that each page is only used by a single thread and thus placed on its NUMA
+             * node on first touch.
              */
-            template <class T, class Extent>
-            std::size_t storage_size(pos3<std::size_t> const &block_size) {
-                auto bs = full_block_size<T, Extent>(block_size);
-                // allocate one extra cache line to allow for offsetting the initial allocation
-                // to guarantee alignment of first element inside domain
-                constexpr std::size_t extra = (byte_alignment::value + sizeof(T) - 1) / sizeof(T);
-                return bs.i * bs.j * bs.k * omp_get_max_threads() + extra;
+            template <class T>
+            std::size_t thread_block_size(std::size_t size) {
+                constexpr std::size_t page_size = 4096;
+                std::size_t padded_bytesize = (size * sizeof(T) + page_size - 1) / page_size * page_size;
+                return padded_bytesize % sizeof(T) == 0 ? padded_bytesize / sizeof(T) : size;
             }
 
-            template <std::size_t, class>
+            template <std::size_t, class, bool>
             struct strides_kind_impl;
 
             /**
-             * @brief Strides kind tag. Strides depend on data type size (due to cache-line alignment) and extent.
+             * @brief Strides kind tag. Strides depend on data type size (due to cache-line alignment), extent and on
+             * whether the k dimension is stored.
              */
-            template <class T, class Extent>
-            using strides_kind = strides_kind_impl<sizeof(T), Extent>;
+            template <class T, class Extent, bool AllParallel>
+            using strides_kind = strides_kind_impl<sizeof(T),
+                Extent,
+                AllParallel && Extent::kminus::value == 0 && Extent::kplus::value == 0>;
 
             /**
              * @brief Strides, depending on data type due to padding to cache-line size. Specialization for non-zero
@@ -82,7 +86,7 @@ namespace gridtools {
             hymap::keys<dim::i, dim::j, dim::k, dim::thread>::values<integral_constant<int_t, 1>, int_t, int_t, int_t>
             strides(pos3<std::size_t> const &block_size) {
                 auto bs = full_block_size<T, Extent>(block_size);
-                return {integral_constant<int, 1>{}, bs.i * bs.k, bs.i, bs.i * bs.j * bs.k};
+                return {integral_constant<int, 1>{}, bs.i * bs.k, bs.i, thread_block_size<T>(bs.i * bs.j * bs.k)};
             }
 
             /**
@@ -96,7 +100,7 @@ namespace gridtools {
             hymap::keys<dim::i, dim::j, dim::thread>::values<integral_constant<int_t, 1>, int_t, int_t> strides(
                 pos3<std::size_t> const &block_size) {
                 auto bs = full_block_size<T, Extent>(block_size);
-                return {integral_constant<int, 1>{}, bs.i, bs.i * bs.j};
+                return {integral_constant<int, 1>{}, bs.i, thread_block_size<T>(bs.i * bs.j)};
             }
 
             /**
@@ -112,26 +116,52 @@ namespace gridtools {
                 return pad<T>(offset);
             }
 
-            struct make_allocation_f {
-                auto operator()(size_t size) const {
-                    return std::unique_ptr<void, GT_INTEGRAL_CONSTANT_FROM_VALUE(&hugepage_free)>(hugepage_alloc(size));
-                }
-            };
+            /**
+             * @brief Size of the full allocation of a temporary buffer (in number of elements).
+             */
+            template <class T, class Extent, bool AllParallel>
+            std::size_t storage_size(pos3<std::size_t> const &block_size) {
+                // allocate one extra cache line to allow for offsetting the initial allocation
+                // to guarantee alignment of first element inside domain
+                constexpr std::size_t extra = (byte_alignment::value + sizeof(T) - 1) / sizeof(T);
+                return sid::get_stride<dim::thread>(strides<T, Extent, AllParallel>(block_size)) *
+                           omp_get_max_threads() +
+                       extra;
+            }
+
+            /**
+             * @brief Touches the memory region of each thread from within that thread, to place it on the thread's
+             * NUMA node.
+             */
+            template <class T, class Extent, bool AllParallel>
+            void first_touch(T *ptr, pos3<std::size_t> const &block_size) {
+                std::size_t thread_stride =
+                    sid::get_stride<dim::thread>(strides<T, Extent, AllParallel>(block_size));
+                int threads = omp_get_max_threads();
+#pragma omp parallel for schedule(static, 1)
+                for (int t = 0; t < threads; ++t)
+                    numa_touch(ptr + t * thread_stride, thread_stride * sizeof(T));
+            }
         } // namespace _impl_tmp_mc
 
         /**
-         * @brief Simple allocator for temporaries.
+         * @brief Allocator for temporaries, all temporaries of a computation share a single huge page slab.
          */
-        using tmp_allocator_mc = sid::cached_allocator<_impl_tmp_mc::make_allocation_f>;
+        using tmp_allocator_mc = sid::arena_allocator<make_hugepage_unique_f>;
 
         template <class T, class Extent, bool AllParallel, class Allocator>
         auto make_tmp_storage_mc(Allocator &allocator, pos3<std::size_t> const &block_size) {
+            auto ptr_holder = allocate(
+                allocator, meta::lazy::id<T>(), _impl_tmp_mc::storage_size<T, Extent, AllParallel>(block_size));
+            // the pages of a reused slab are already placed, touching them again would only cost time
+            using sid::is_fresh;
+            if (is_fresh(allocator, ptr_holder()))
+                _impl_tmp_mc::first_touch<T, Extent, AllParallel>(ptr_holder(), block_size);
             return sid::synthetic()
                 .set<sid::property::origin>(
-                    allocate(allocator, meta::lazy::id<T>(), _impl_tmp_mc::storage_size<T, Extent>(block_size)) +
-                    _impl_tmp_mc::origin_offset<T, Extent, AllParallel>(block_size))
+                    std::move(ptr_holder) + _impl_tmp_mc::origin_offset<T, Extent, AllParallel>(block_size))
                 .template set<sid::property::strides>(_impl_tmp_mc::strides<T, Extent, AllParallel>(block_size))
-                .template set<sid::property::strides_kind, _impl_tmp_mc::strides_kind<T, Extent>>()
+                .template set<sid::property::strides_kind, _impl_tmp_mc::strides_kind<T, Extent, AllParallel>>()
                 .template set<sid::property::ptr_diff, int_t>();
         }
     } // namespace mc
@@ -36,7 +36,8 @@ namespace gridtools {
                 auto alloc = sid::make_allocator(&std::make_unique<char[]>);
                 using stages_t = be_api::make_split_view<Spec>;
                 using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-                auto temporaries = be_api::make_data_stores(tmp_plh_map_t(), [&](auto info) {
+                using tmp_buffers_t = be_api::tmp_buffers<stages_t, tmp_plh_map_t>;
+                auto temporaries = be_api::make_buffer_data_stores(tmp_buffers_t(), [&](auto info) {
                     auto extent = info.extent();
                     auto interval = stages_t::interval();
                     auto num_colors = info.num_colors();
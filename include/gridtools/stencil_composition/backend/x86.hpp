@@ -9,12 +9,14 @@
  */
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <utility>
 
 #include "../../common/defs.hpp"
 #include "../../common/generic_metafunctions/for_each.hpp"
 #include "../../common/host_device.hpp"
+#include "../../common/hugepage_alloc.hpp"
 #include "../../common/integral_constant.hpp"
 #include "../../common/omp.hpp"
 #include "../../common/tuple.hpp"
@@ -29,6 +31,7 @@
 #include "../../sid/loop.hpp"
 #include "../../sid/sid_shift_origin.hpp"
 #include "../be_api.hpp"
+#include "../common/block_size_tuner.hpp"
 #include "../common/dim.hpp"
 
 namespace gridtools {
@@ -79,39 +82,56 @@ namespace gridtools {
             };
         }
 
-        template <class IBlockSize = integral_constant<int_t, 8>, class JBlockSize = integral_constant<int_t, 8>>
-        struct backend {};
+        template <class T>
+        T make_block_size(T block_size) {
+            return block_size;
+        }
 
-        template <class IBlockSize, class JBlockSize, class Spec, class Grid, class DataStores>
-        void gridtools_backend_entry_point(
-            backend<IBlockSize, JBlockSize>, Spec, Grid const &grid, DataStores external_data_stores) {
-            using stages_t = be_api::make_split_view<Spec>;
+        inline int_t make_block_size(int_t block_size) { return block_size > 0 ? block_size : 8; }
+
+        using tmp_allocator_t = sid::arena_allocator<make_hugepage_unique_f>;
 
-            auto alloc = sid::make_cached_allocator(&std::make_unique<char[]>);
+        /**
+         * @brief Does the setup of the computation and returns a callable that executes it.
+         *
+         * The temporaries are allocated from `alloc`, which has to outlive the returned callable.
+         */
+        template <class Spec, class Grid, class DataStores, class IBlockSize, class JBlockSize>
+        auto make_blocked_run(Spec,
+            Grid const &grid,
+            DataStores external_data_stores,
+            IBlockSize i_block_size,
+            JBlockSize j_block_size,
+            tmp_allocator_t &alloc) {
+            using stages_t = be_api::make_split_view<Spec>;
 
             using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-            auto temporaries = be_api::make_data_stores(tmp_plh_map_t(), [&grid, &alloc](auto info) {
-                auto extent = info.extent();
-                auto interval = stages_t::interval();
-                auto num_colors = info.num_colors();
-                auto offsets = tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(
-                    -extent.minus(dim::i()), -extent.minus(dim::j()), -grid.k_start(interval) - extent.minus(dim::k()));
-                auto sizes =
-                    tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::values>(num_colors,
-                        grid.k_size(interval, extent),
-                        extent.extend(dim::j(), JBlockSize()),
-                        extent.extend(dim::i(), IBlockSize()),
-                        omp_get_max_threads());
-
-                using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
-                return sid::shift_sid_origin(
-                    sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
-            });
+            using tmp_buffers_t = be_api::tmp_buffers<stages_t, tmp_plh_map_t>;
+            auto temporaries = be_api::make_buffer_data_stores(
+                tmp_buffers_t(), [&grid, &alloc, i_block_size, j_block_size](auto info) {
+                    auto extent = info.extent();
+                    auto interval = stages_t::interval();
+                    auto num_colors = info.num_colors();
+                    auto offsets =
+                        tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(-extent.minus(dim::i()),
+                            -extent.minus(dim::j()),
+                            -grid.k_start(interval) - extent.minus(dim::k()));
+                    auto sizes =
+                        tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::values>(num_colors,
+                            grid.k_size(interval, extent),
+                            extent.extend(dim::j(), j_block_size),
+                            extent.extend(dim::i(), i_block_size),
+                            omp_get_max_threads());
+
+                    using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
+                    return sid::shift_sid_origin(
+                        sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
+                });
 
             auto blocked_external_data_stores = tuple_util::transform(
                 [&](auto &&data_store) {
                     return sid::block(std::forward<decltype(data_store)>(data_store),
-                        hymap::keys<dim::i, dim::j>::values<IBlockSize, JBlockSize>());
+                        tuple_util::make<hymap::keys<dim::i, dim::j>::values>(i_block_size, j_block_size));
                 },
                 std::move(external_data_stores));
 
@@ -123,17 +143,129 @@ namespace gridtools {
             int_t total_i = grid.i_size();
             int_t total_j = grid.j_size();
 
-            int_t NBI = (total_i + IBlockSize::value - 1) / IBlockSize::value;
-            int_t NBJ = (total_j + JBlockSize::value - 1) / JBlockSize::value;
+            int_t NBI = (total_i + i_block_size - 1) / i_block_size;
+            int_t NBJ = (total_j + j_block_size - 1) / j_block_size;
 
+            return [stage_loops = std::move(stage_loops),
+                       total_i,
+                       total_j,
+                       NBI,
+                       NBJ,
+                       i_block_size = (int_t)i_block_size,
+                       j_block_size = (int_t)j_block_size] {
 #pragma omp parallel for collapse(2)
-            for (int_t bi = 0; bi < NBI; ++bi) {
-                for (int_t bj = 0; bj < NBJ; ++bj) {
-                    int_t i_size = bi + 1 == NBI ? total_i - bi * IBlockSize::value : IBlockSize::value;
-                    int_t j_size = bj + 1 == NBJ ? total_j - bj * JBlockSize::value : JBlockSize::value;
-                    tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops);
+                for (int_t bi = 0; bi < NBI; ++bi) {
+                    for (int_t bj = 0; bj < NBJ; ++bj) {
+                        int_t i_size = bi + 1 == NBI ? total_i - bi * i_block_size : i_block_size;
+                        int_t j_size = bj + 1 == NBJ ? total_j - bj * j_block_size : j_block_size;
+                        tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops);
+                    }
                 }
-            }
+            };
+        }
+
+        template <class Spec, class Grid, class DataStores, class IBlockSize, class JBlockSize>
+        void run_blocked(Spec,
+            Grid const &grid,
+            DataStores external_data_stores,
+            IBlockSize i_block_size,
+            JBlockSize j_block_size) {
+            tmp_allocator_t alloc;
+            make_blocked_run(Spec(), grid, std::move(external_data_stores), i_block_size, j_block_size, alloc)();
+        }
+
+        template <class Spec, class Grid, class DataStores, class IBlockSize, class JBlockSize>
+        auto make_blocked_computation(Spec,
+            Grid const &grid,
+            DataStores external_data_stores,
+            IBlockSize i_block_size,
+            JBlockSize j_block_size) {
+            auto alloc = std::make_shared<tmp_allocator_t>();
+            return [alloc,
+                       run = make_blocked_run(
+                           Spec(), grid, std::move(external_data_stores), i_block_size, j_block_size, *alloc)] {
+                run();
+            };
+        }
+
+        /**
+         * @brief Backend for CPUs with blocking along i and j.
+         *
+         * The block sizes are either compile time constants (`integral_constant<int_t, N>`, the default) or run time
+         * values (`int_t`), for example `x86::backend<int_t, int_t>{16, 4}`. Non-positive run time values select the
+         * default block size of 8.
+         */
+        template <class IBlockSize = integral_constant<int_t, 8>, class JBlockSize = integral_constant<int_t, 8>>
+        struct backend {
+            IBlockSize i_block_size = {};
+            JBlockSize j_block_size = {};
+        };
+
+        /**
+         * @brief Backend with run time block sizes, which can optionally be chosen by a `block_size_tuner`.
+         */
+        template <>
+        struct backend<int_t, int_t> {
+            int_t i_block_size = 0;
+            int_t j_block_size = 0;
+            block_size_tuner *tuner = nullptr;
+        };
+
+        template <class IBlockSize, class JBlockSize, class Spec, class Grid, class DataStores>
+        void gridtools_backend_entry_point(
+            backend<IBlockSize, JBlockSize> const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+            run_blocked(Spec(),
+                grid,
+                std::move(external_data_stores),
+                make_block_size(be.i_block_size),
+                make_block_size(be.j_block_size));
+        }
+
+        template <class Spec, class Grid, class DataStores>
+        void gridtools_backend_entry_point(
+            backend<int_t, int_t> const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+            if (be.tuner)
+                be.tuner->run(Spec(), grid, [&](int_t i_block_size, int_t j_block_size) {
+                    run_blocked(Spec(),
+                        grid,
+                        std::move(external_data_stores),
+                        make_block_size(i_block_size),
+                        make_block_size(j_block_size));
+                });
+            else
+                run_blocked(Spec(),
+                    grid,
+                    std::move(external_data_stores),
+                    make_block_size(be.i_block_size),
+                    make_block_size(be.j_block_size));
+        }
+
+        template <class IBlockSize, class JBlockSize, class Spec, class Grid, class DataStores>
+        auto gridtools_backend_make_computation(
+            backend<IBlockSize, JBlockSize> const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+            return make_blocked_computation(Spec(),
+                grid,
+                std::move(external_data_stores),
+                make_block_size(be.i_block_size),
+                make_block_size(be.j_block_size));
+        }
+
+        /**
+         * @brief Prepared computation. With a `block_size_tuner` the setup is repeated on each call, as the block sizes
+         * may change between calls.
+         */
+        template <class Spec, class Grid, class DataStores>
+        std::function<void()> gridtools_backend_make_computation(
+            backend<int_t, int_t> const &be, Spec, Grid const &grid, DataStores external_data_stores) {
+            if (be.tuner)
+                return [be, grid, external_data_stores = std::move(external_data_stores)] {
+                    gridtools_backend_entry_point(be, Spec(), grid, external_data_stores);
+                };
+            return make_blocked_computation(Spec(),
+                grid,
+                std::move(external_data_stores),
+                make_block_size(be.i_block_size),
+                make_block_size(be.j_block_size));
         }
     } // namespace x86
 } // namespace gridtools
@@ -395,11 +395,133 @@ namespace gridtools {
         using make_split_view = meta::rename<aggregated_view,
             meta::transform<make_split_view_item, meta::flatten<meta::transform<fuse_stage_rows, Matrices>>>>;
 
+        /*
+         *  Liveness analysis of temporaries.
+         *
+         *  The lifetime of a temporary spans from the first to the last item (stage) of a view that accesses it.
+         *  Temporaries with disjoint lifetimes and the same buffer key share a single buffer. The buffer key is
+         *  defined by the backend and has to contain everything that determines the layout of the buffer.
+         */
+        template <class PlhInfo>
+        using default_buffer_key = meta::list<std::remove_const_t<typename PlhInfo::data_t>,
+            typename PlhInfo::extent_t,
+            typename PlhInfo::num_colors_t>;
+
+        template <class Info, class First, class Last>
+        struct tmp_lifetime {
+            using info_t = Info;
+            using first_t = First;
+            using last_t = Last;
+        };
+
+        template <class Key, class Last, class Infos>
+        struct tmp_buffer {
+            using key_t = Key;
+            using last_t = Last;
+            using infos_t = Infos;
+        };
+
+        template <class Plh>
+        struct usage_index_f {
+            // the same placeholder may appear with different caches in an item
+            template <class Item, class I>
+            using apply =
+                meta::if_<meta::st_contains<meta::dedup<typename Item::plhs_t>, Plh>, meta::list<I>, meta::list<>>;
+        };
+
+        template <class Items>
+        struct make_tmp_lifetime_f {
+            template <class Info,
+                class Usage = meta::flatten<meta::transform<usage_index_f<typename Info::plh_t>::template apply,
+                    Items,
+                    meta::make_indices_for<Items>>>>
+            using apply = tmp_lifetime<Info, meta::first<Usage>, meta::last<Usage>>;
+        };
+
+        template <class I>
+        struct starts_at_f {
+            template <class Lifetime>
+            using apply = std::is_same<typename Lifetime::first_t, I>;
+        };
+
+        template <class Lifetimes>
+        struct lifetimes_starting_at_f {
+            template <class I>
+            using apply = meta::filter<starts_at_f<I>::template apply, Lifetimes>;
+        };
+
+        template <template <class...> class GetBufferKey, class Lifetime, class Buffers, std::size_t Pos>
+        struct assign_buffer {
+            using buffer_t = meta::at_c<Buffers, Pos>;
+            using type = meta::replace_at_c<Buffers,
+                Pos,
+                tmp_buffer<typename buffer_t::key_t,
+                    typename Lifetime::last_t,
+                    meta::push_back<typename buffer_t::infos_t, typename Lifetime::info_t>>>;
+        };
+
+        // no free buffer: add a new one
+        template <template <class...> class GetBufferKey, class Lifetime, class... Buffers>
+        struct assign_buffer<GetBufferKey, Lifetime, meta::list<Buffers...>, sizeof...(Buffers)> {
+            using type = meta::list<Buffers...,
+                tmp_buffer<GetBufferKey<typename Lifetime::info_t>,
+                    typename Lifetime::last_t,
+                    meta::list<typename Lifetime::info_t>>>;
+        };
+
+        template <template <class...> class GetBufferKey>
+        struct assign_buffer_f {
+            template <class Lifetime>
+            struct is_free_f {
+                template <class Buffer,
+                    class IsCompatible = std::is_same<typename Buffer::key_t, GetBufferKey<typename Lifetime::info_t>>>
+                using apply = bool_constant<IsCompatible::value && (Buffer::last_t::value < Lifetime::first_t::value)>;
+            };
+
+            template <class Buffers,
+                class Lifetime,
+                class Pos = meta::find<meta::transform<is_free_f<Lifetime>::template apply, Buffers>, std::true_type>>
+            using apply = typename assign_buffer<GetBufferKey, Lifetime, Buffers, Pos::value>::type;
+        };
+
+        template <class Buffer>
+        using get_infos = typename Buffer::infos_t;
+
+        /**
+         *  Assigns the temporaries in `PlhMap` to buffers: a list of buffers, each given by the list of the infos of
+         *  the temporaries that share it. Temporaries are assigned greedily in the order of their first use.
+         */
+        template <class Items,
+            class PlhMap,
+            template <class...> class GetBufferKey = default_buffer_key,
+            class ItemList = meta::rename<meta::list, Items>,
+            class Lifetimes = meta::transform<make_tmp_lifetime_f<ItemList>::template apply, PlhMap>,
+            class SortedLifetimes = meta::flatten<
+                meta::transform<lifetimes_starting_at_f<Lifetimes>::template apply, meta::make_indices_for<ItemList>>>>
+        using tmp_buffers = meta::transform<get_infos,
+            meta::lfold<assign_buffer_f<GetBufferKey>::template apply, meta::list<>, SortedLifetimes>>;
+
+        template <class Infos, class I>
+        using buffer_indices = meta::transform<meta::always<I>::template apply, Infos>;
+
+        /**
+         * @brief Creates the data stores of the temporaries in `Buffers`, calling `fun` once per buffer with the info
+         * of its first temporary. All temporaries of a buffer refer to the same data store.
+         */
+        template <template <class...> class GetKey = get_plh, class Buffers, class Fun>
+        auto make_buffer_data_stores(Buffers, Fun &&fun) {
+            using infos_t = meta::flatten<Buffers>;
+            using indices_t = meta::flatten<meta::transform<buffer_indices, Buffers, meta::make_indices_for<Buffers>>>;
+            auto buffers = tuple_util::transform(
+                [&](auto infos) { return fun(meta::first<decltype(infos)>()); }, meta::rename<tuple, Buffers>());
+            return tuple_util::convert_to<meta::rename<hymap::keys, meta::transform<GetKey, infos_t>>::template values>(
+                tuple_util::transform(
+                    [&](auto index) { return tuple_util::get<decltype(index)::value>(buffers); },
+                    meta::rename<tuple, indices_t>()));
+        }
+
         using core::is_backward;
         using core::is_forward;
         using core::is_parallel;
-
-        // used in cuda/fill_flush. TODO: get rid of that?
-        using core::level;
     } // namespace be_api
 } // namespace gridtools
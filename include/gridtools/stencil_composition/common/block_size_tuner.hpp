@@ -0,0 +1,131 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "../../common/array.hpp"
+#include "../../common/defs.hpp"
+#include "../../common/omp.hpp"
+
+namespace gridtools {
+    /**
+     *  Auto-tuner for the i/j block sizes of the CPU backends.
+     *
+     *  The first call for a given stencil specification, grid shape and number of threads is used for warm-up, the
+     *  following calls run with all candidate block sizes in turn and measure the run time. All later calls use the
+     *  fastest candidate. If a file name is given, the tuned block sizes are loaded from and stored to that file, such
+     *  that later executions of the same program do not need to tune again.
+     *
+     *  A block size of zero stands for the default block size of the backend.
+     *
+     *  Usage:
+     *
+     *    block_size_tuner tuner({{8, 8}, {16, 4}, {32, 2}}, "block_sizes.txt");
+     *    for (...)
+     *        run(spec, mc::backend<>{0, 0, &tuner}, grid, fields...);
+     */
+    class block_size_tuner {
+      public:
+        using block_size_t = array<int_t, 2>;
+
+      private:
+        struct state {
+            int_t next = -1; // -1: warm-up run, [0, candidates) index of the next candidate to measure
+            double best_time = std::numeric_limits<double>::max();
+            block_size_t best = {0, 0};
+        };
+
+        std::vector<block_size_t> m_candidates;
+        std::string m_filename;
+        std::map<std::string, state> m_states;
+
+        bool tuned(state const &s) const { return s.next >= (int_t)m_candidates.size(); }
+
+        void load() {
+            std::ifstream in(m_filename);
+            std::string key;
+            state s;
+            s.next = m_candidates.size();
+            while (in >> key >> s.best[0] >> s.best[1])
+                m_states[key] = s;
+        }
+
+        void store() const {
+            std::ofstream out(m_filename);
+            for (auto &&item : m_states)
+                if (tuned(item.second))
+                    out << item.first << " " << item.second.best[0] << " " << item.second.best[1] << "\n";
+        }
+
+        template <class Spec, class Grid>
+        static std::string make_key(Grid const &grid) {
+            std::ostringstream key;
+            key << typeid(Spec).name() << "_" << grid.i_size() << "_" << grid.j_size() << "_" << grid.k_size() << "_"
+                << omp_get_max_threads();
+            return key.str();
+        }
+
+      public:
+        block_size_tuner(std::vector<block_size_t> candidates = {{0, 0}, {8, 8}, {16, 4}, {32, 4}, {64, 2}},
+            std::string filename = "")
+            : m_candidates(std::move(candidates)), m_filename(std::move(filename)) {
+            if (!m_filename.empty())
+                load();
+        }
+
+        /**
+         * @brief Calls `fun(i_block_size, j_block_size)` with the block size to use for this call and measures its
+         * run time if still tuning.
+         */
+        template <class Spec, class Grid, class Fun>
+        void run(Spec, Grid const &grid, Fun &&fun) {
+            auto &s = m_states[make_key<Spec>(grid)];
+            if (tuned(s)) {
+                fun(s.best[0], s.best[1]);
+                return;
+            }
+            if (s.next < 0) {
+                ++s.next;
+                fun(m_candidates.front()[0], m_candidates.front()[1]);
+                return;
+            }
+            auto const &candidate = m_candidates[s.next];
+            auto start = std::chrono::steady_clock::now();
+            fun(candidate[0], candidate[1]);
+            double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (time < s.best_time) {
+                s.best_time = time;
+                s.best = candidate;
+            }
+            if (++s.next == (int_t)m_candidates.size() && !m_filename.empty())
+                store();
+        }
+
+        /**
+         * @brief Tuned block sizes of all specifications and grids that finished tuning, by opaque key.
+         */
+        std::map<std::string, block_size_t> best() const {
+            std::map<std::string, block_size_t> res;
+            for (auto &&item : m_states)
+                if (tuned(item.second))
+                    res.emplace(item.first, item.second.best);
+            return res;
+        }
+    };
+} // namespace gridtools
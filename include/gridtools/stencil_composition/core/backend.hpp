@@ -31,15 +31,41 @@ namespace gridtools {
 
             template <class Backend, class Spec>
             struct backend_entry_point_f {
+                Backend m_backend;
+
                 template <class Grid, class DataStores>
                 void operator()(Grid const &grid, DataStores data_stores) const {
-                    gridtools_backend_entry_point(Backend(),
+                    gridtools_backend_entry_point(m_backend,
                         convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>(),
                         grid,
                         shift_origin(grid, std::move(data_stores)));
                 }
             };
+
+            /**
+             *  Default for backends that do not provide a prepared computation: the computation calls the backend
+             *  entry point on each invocation.
+             *
+             *  Backends can overload `gridtools_backend_make_computation` (found by ADL) to do the setup of the
+             *  computation (allocation of temporaries, blocking, etc.) once and return a callable that just runs it.
+             */
+            template <class Backend, class Spec, class Grid, class DataStores>
+            auto gridtools_backend_make_computation(
+                Backend const &backend, Spec, Grid const &grid, DataStores data_stores) {
+                return [backend, grid, data_stores = std::move(data_stores)] {
+                    gridtools_backend_entry_point(backend, Spec(), grid, data_stores);
+                };
+            }
+
+            template <class Backend, class Spec, class Grid, class DataStores>
+            auto make_backend_computation(Backend const &backend, Grid const &grid, DataStores data_stores) {
+                return gridtools_backend_make_computation(backend,
+                    convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>(),
+                    grid,
+                    shift_origin(grid, std::move(data_stores)));
+            }
         } // namespace backend_impl_
         using backend_impl_::backend_entry_point_f;
+        using backend_impl_::make_backend_computation;
     } // namespace core
 } // namespace gridtools
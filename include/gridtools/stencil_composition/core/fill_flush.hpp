@@ -14,19 +14,20 @@
 #include <type_traits>
 #include <utility>
 
-#include "../../../common/defs.hpp"
-#include "../../../common/host_device.hpp"
-#include "../../../common/hymap.hpp"
-#include "../../../common/integral_constant.hpp"
-#include "../../../sid/concept.hpp"
-#include "../../be_api.hpp"
-#include "../../common/caches.hpp"
-#include "../../common/dim.hpp"
-#include "../../global_parameter.hpp"
-#include "../../positional.hpp"
+#include "../../common/defs.hpp"
+#include "../../common/host_device.hpp"
+#include "../../common/hymap.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../sid/concept.hpp"
+#include "../be_api.hpp"
+#include "../common/caches.hpp"
+#include "../common/dim.hpp"
+#include "../global_parameter.hpp"
+#include "../positional.hpp"
+#include "level.hpp"
 
 namespace gridtools {
-    namespace cuda {
+    namespace core {
         namespace fill_flush {
             namespace impl_ {
                 template <class Cells>
@@ -212,8 +213,8 @@ namespace gridtools {
                 constexpr int_t real_offset(int_t x) { return x > 0 ? x - 1 : x; }
 
                 template <uint_t Splitter, int_t OffsetLimit, int_t FromOffset, int_t ToOffset, int_t Lim>
-                struct levels_are_close<be_api::level<Splitter, FromOffset, OffsetLimit>,
-                    be_api::level<Splitter, ToOffset, OffsetLimit>,
+                struct levels_are_close<level<Splitter, FromOffset, OffsetLimit>,
+                    level<Splitter, ToOffset, OffsetLimit>,
                     Lim> : bool_constant<(real_offset(ToOffset) - real_offset(FromOffset) < Lim)> {};
 
                 template <class PlhInfo, class Execution, class FirstInterval, class LastInterval, class CurInterval>
@@ -334,5 +335,5 @@ namespace gridtools {
             using impl_::transform_data_stores;
             using impl_::transform_spec;
         } // namespace fill_flush
-    }     // namespace cuda
+    }     // namespace core
 } // namespace gridtools
@@ -90,6 +90,21 @@ namespace gridtools {
                 return tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(m_i_start, m_j_start, offset());
             }
 
+            /**
+             * @brief The grid restricted to the horizontal region of `i_size` x `j_size` points that starts `i_offset`,
+             * `j_offset` points from the origin of this grid. The vertical axis is not changed.
+             */
+            grid horizontal_region(int_t i_offset, int_t i_size, int_t j_offset, int_t j_size) const {
+                assert(i_offset >= 0 && i_size >= 0 && i_offset + i_size <= m_i_size);
+                assert(j_offset >= 0 && j_size >= 0 && j_offset + j_size <= m_j_size);
+                grid res = *this;
+                res.m_i_start += i_offset;
+                res.m_i_size = i_size;
+                res.m_j_start += j_offset;
+                res.m_j_size = j_size;
+                return res;
+            }
+
             template <class Extent = extent<>>
             int_t i_size(Extent extent = {}) const {
                 return extent.extend(dim::i(), m_i_size);
@@ -138,20 +138,20 @@ namespace gridtools {
         }
 
         template <size_t Factor, class Spec, class Backend, size_t... Is, class Grid, class... Fields>
-        void expanded_run(Grid const &grid, size_t offset, const Fields &... fields) {
-            core::backend_entry_point_f<Backend, expand_spec<std::integral_constant<size_t, Factor>, Spec>>()(
+        void expanded_run(Backend const &be, Grid const &grid, size_t offset, const Fields &... fields) {
+            core::backend_entry_point_f<Backend, expand_spec<std::integral_constant<size_t, Factor>, Spec>>{be}(
                 grid, make_data_store_map<Factor, Is...>(offset, fields...));
         }
 
         template <size_t Factor, class Comp, class Backend, class Grid, class... Fields, size_t... Is>
-        void run_impl(Comp comp, Backend, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields) {
+        void run_impl(Comp comp, Backend be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields) {
             using spec_t = decltype(comp(make_arg<Is, Fields>()...));
             size_t size = get_expandable_size(fields...);
             size_t offset = 0;
             for (; size - offset >= Factor; offset += Factor)
-                expanded_run<Factor, spec_t, Backend, Is...>(grid, offset, fields...);
+                expanded_run<Factor, spec_t, Backend, Is...>(be, grid, offset, fields...);
             for (; offset < size; ++offset)
-                expanded_run<1, spec_t, Backend, Is...>(grid, offset, fields...);
+                expanded_run<1, spec_t, Backend, Is...>(be, grid, offset, fields...);
         }
 
         template <size_t Factor, class Comp, class Backend, class Grid, class... Fields>
@@ -12,9 +12,12 @@
 
 #include <utility>
 
+#include "../../common/defs.hpp"
 #include "../../common/hymap.hpp"
 #include "../../meta.hpp"
 #include "../common/caches.hpp"
+#include "../common/dim.hpp"
+#include "../common/extent.hpp"
 #include "../core/backend.hpp"
 #include "../core/cache_info.hpp"
 #include "../core/compute_extents_metafunctions.hpp"
@@ -105,11 +108,11 @@ namespace gridtools {
         struct arg {};
 
         template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
-        void run_impl(Comp comp, Backend, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields) {
+        void run_impl(Comp comp, Backend be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields) {
             using spec_t = decltype(comp(arg<Is>()...));
             using entry_point_t = core::backend_entry_point_f<Backend, spec_t>;
             using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields &...>;
-            entry_point_t()(grid, data_store_map_t{fields...});
+            entry_point_t{std::move(be)}(grid, data_store_map_t{fields...});
         }
 
         template <class Comp, class Backend, class Grid, class... Fields>
@@ -117,6 +120,87 @@ namespace gridtools {
             run_impl(comp, be, grid, std::index_sequence_for<Fields...>(), std::forward<Fields>(fields)...);
         }
 
+        template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
+        auto make_computation_impl(
+            Comp comp, Backend be, Grid const &grid, std::index_sequence<Is...>, Fields &... fields) {
+            using spec_t = decltype(comp(arg<Is>()...));
+            using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields &...>;
+            return core::make_backend_computation<Backend, spec_t>(std::move(be), grid, data_store_map_t{fields...});
+        }
+
+        /**
+         * @brief Prepares the computation `comp` on the given fields for repeated execution.
+         *
+         * Unlike `run`, the setup of the computation is done only once here. The fields are bound by reference and
+         * have to outlive the returned callable, which executes the computation when called without arguments:
+         *
+         *   auto comp = make_computation(spec, backend, grid, in, out);
+         *   for (int t = 0; t < steps; ++t)
+         *       comp();
+         */
+        template <class Comp, class Backend, class Grid, class... Fields>
+        auto make_computation(Comp comp, Backend be, Grid const &grid, Fields &... fields) {
+            return make_computation_impl(comp, std::move(be), grid, std::index_sequence_for<Fields...>(), fields...);
+        }
+
+        template <class Comp, class Backend, class Grid, class Start, class Wait, class... Fields, size_t... Is>
+        void run_overlapped_impl(Comp comp,
+            Backend const &be,
+            Grid const &grid,
+            Start &start,
+            Wait &wait,
+            std::index_sequence<Is...> is,
+            Fields &... fields) {
+            using spec_t = decltype(comp(arg<Is>()...));
+            using extent_t = enclosing_extent<decltype(get_arg_extent(spec_t(), arg<Is>()))...>;
+            int_t i_minus = -extent_t::minus(dim::i());
+            int_t i_plus = extent_t::plus(dim::i());
+            int_t j_minus = -extent_t::minus(dim::j());
+            int_t j_plus = extent_t::plus(dim::j());
+            int_t i_size = grid.i_size();
+            int_t j_size = grid.j_size();
+            int_t i_inner = i_size - i_minus - i_plus;
+            int_t j_inner = j_size - j_minus - j_plus;
+
+            auto run_region = [&](int_t i_offset, int_t i_size, int_t j_offset, int_t j_size) {
+                if (i_size > 0 && j_size > 0)
+                    run_impl(comp, be, grid.horizontal_region(i_offset, i_size, j_offset, j_size), is, fields...);
+            };
+
+            start();
+            if (i_inner <= 0 || j_inner <= 0) {
+                wait();
+                run_region(0, i_size, 0, j_size);
+                return;
+            }
+            run_region(i_minus, i_inner, j_minus, j_inner);
+            wait();
+            run_region(0, i_size, 0, j_minus);
+            run_region(0, i_size, j_size - j_plus, j_plus);
+            run_region(0, i_minus, j_minus, j_inner);
+            run_region(i_size - i_plus, i_plus, j_minus, j_inner);
+        }
+
+        /**
+         * @brief Runs `comp` while the halos of the fields are exchanged.
+         *
+         * The horizontal domain is split into the interior, which does not access the halos, and the boundary strips
+         * whose widths are given by the extents of the arguments (see `get_arg_extent`). `start()` is called first,
+         * then the interior is computed, then `wait()` is called before the strips are computed. Typically `start`
+         * packs the fields and starts a split-phase halo exchange, while `wait` completes it and unpacks:
+         *
+         *   run_overlapped(spec, backend, grid,
+         *       [&] { he.pack(fields); he.start_exchange(); },
+         *       [&] { he.wait(); he.unpack(fields); },
+         *       out, in);
+         *
+         * If the domain is too small to have an interior, `wait()` is called right after `start()`.
+         */
+        template <class Comp, class Backend, class Grid, class Start, class Wait, class... Fields>
+        void run_overlapped(Comp comp, Backend be, Grid const &grid, Start &&start, Wait &&wait, Fields &&... fields) {
+            run_overlapped_impl(comp, be, grid, start, wait, std::index_sequence_for<Fields...>(), fields...);
+        }
+
         template <class F, class Backend, class Grid, class... Fields>
         void run_single_stage(F, Backend be, Grid const &grid, Fields &&... fields) {
             return run([](auto... args) { return execute_parallel().stage(F(), args...); },
@@ -152,7 +236,9 @@ namespace gridtools {
     using frontend_impl_::execute_parallel;
     using frontend_impl_::get_arg_extent;
     using frontend_impl_::get_arg_intent;
+    using frontend_impl_::make_computation;
     using frontend_impl_::multi_pass;
     using frontend_impl_::run;
+    using frontend_impl_::run_overlapped;
     using frontend_impl_::run_single_stage;
 } // namespace gridtools
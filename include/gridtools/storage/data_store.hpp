@@ -49,6 +49,7 @@ namespace gridtools {
                 mutable_data_t *m_target_ptr;
 
               public:
+                using traits_t = Traits;
                 using layout_t = traits::layout_type<Traits, N>;
                 using data_t = T;
                 static constexpr size_t ndims = N;
@@ -15,6 +15,7 @@
 #include "../common/hugepage_alloc.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/layout_map.hpp"
+#include "../common/numa.hpp"
 
 namespace gridtools {
     namespace storage {
@@ -50,9 +51,18 @@ namespace gridtools {
 
             friend integral_constant<size_t, 64> storage_alignment(mc) { return {}; }
 
+            /**
+             * The memory is first-touched in parallel in equal contiguous chunks per thread, which approximates the
+             * decomposition of the mc backend along the outermost dimension (j for the mc layout). Thus most pages are
+             * placed on the NUMA nodes of the threads that will compute on them, independently of how the storage is
+             * initialized later; halos, padding, 4D layouts, dynamic schedules and tuned block sizes move the
+             * boundaries of the chunks of the computation.
+             */
             template <class LazyType, class T = typename LazyType::type>
             friend auto storage_allocate(mc, LazyType, size_t size) {
-                return std::unique_ptr<T[], mc_impl_::deleter>(static_cast<T *>(hugepage_alloc(size * sizeof(T))));
+                void *ptr = hugepage_alloc(size * sizeof(T));
+                numa_first_touch(ptr, size * sizeof(T));
+                return std::unique_ptr<T[], mc_impl_::deleter>(static_cast<T *>(ptr));
             }
         };
     } // namespace storage
@@ -26,7 +26,7 @@ using backend_t = gridtools::x86::backend<>;
 using backend_t = gridtools::naive::backend;
 #elif defined(GT_BACKEND_MC)
 #include "../stencil_composition/backend/mc.hpp"
-using backend_t = gridtools::mc::backend;
+using backend_t = gridtools::mc::backend<>;
 #elif defined(GT_BACKEND_CUDA)
 #ifdef __CUDACC__
 #include "../stencil_composition/backend/cuda.hpp"
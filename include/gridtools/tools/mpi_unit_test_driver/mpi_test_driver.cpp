@@ -23,7 +23,13 @@ int main(int argc, char **argv) {
 
     // We need to set the communicator policy at the top level
     // this allows us to build multiple communicators in the tests
+#ifdef GT_MPI_THREAD_MULTIPLE
+    // the tests start the communication progress thread, which calls MPI as well
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+#else
     MPI_Init(&argc, &argv);
+#endif
     gridtools::GCL_Init(argc, argv);
 
     // initialize google test environment
@@ -9,8 +9,11 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <iostream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "../common/timer/timer.hpp"
 #include "backend_select.hpp"
@@ -29,13 +32,13 @@ namespace gridtools {
         }
 
         template <class Comp>
-        void benchmark(Comp &&comp) const {
+        void benchmark(Comp &&comp, std::string const &name = "NoName") const {
             if (s_steps == 0)
                 return;
             // we run a first time the stencil, since if there is data allocation before by other codes, the first run
             // of the stencil is very slow (we dont know why). The flusher should make sure we flush the cache
             comp();
-            timer<timer_impl_t> timer = {"NoName"};
+            timer<timer_impl_t> timer = {name};
             for (size_t i = 0; i != s_steps; ++i) {
 #ifndef __CUDACC__
                 flush_cache();
@@ -46,5 +49,32 @@ namespace gridtools {
             }
             std::cout << timer.to_string() << std::endl;
         }
+
+        /**
+         * Like `benchmark`, but additionally reports the distribution of the single call times, which is relevant for
+         * tail latency.
+         */
+        template <class Comp>
+        void benchmark_latency(Comp &&comp, std::string const &name = "NoName") const {
+            if (s_steps == 0)
+                return;
+            comp();
+            std::vector<double> times;
+            timer<timer_impl_t> timer = {name};
+            for (size_t i = 0; i != s_steps; ++i) {
+#ifndef __CUDACC__
+                flush_cache();
+#endif
+                double before = timer.total_time();
+                timer.start();
+                comp();
+                timer.pause();
+                times.push_back(timer.total_time() - before);
+            }
+            std::sort(times.begin(), times.end());
+            auto percentile = [&](double p) { return times[std::min(times.size() - 1, size_t(p * times.size()))]; };
+            std::cout << timer.to_string() << " min " << times.front() << " median " << percentile(.5) << " p90 "
+                      << percentile(.9) << " max " << times.back() << std::endl;
+        }
     };
 } // namespace gridtools
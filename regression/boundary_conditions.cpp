@@ -9,6 +9,7 @@
  */
 
 #include <gridtools/boundary_conditions/boundary.hpp>
+#include <gridtools/boundary_conditions/stencil_boundary.hpp>
 #include <gridtools/tools/backend_select.hpp>
 #include <gridtools/tools/cartesian_regression_fixture.hpp>
 #include <gridtools/tools/grid_fixture.hpp>
@@ -72,6 +73,12 @@ namespace {
     void apply_boundary(array<halo_descriptor, 3> const &halos, Src &src, Dst &dst) {
         gridtools::make_boundary<gcl_arch_t>(halos, direction_bc_input{factor}).apply(src, dst);
     }
+
+    template <typename Src, typename Dst>
+    void apply_stencil_boundary(array<halo_descriptor, 3> const &halos, Src &src, Dst &dst) {
+        gridtools::make_stencil_boundary<backend_t>(halos, direction_bc_input{factor}).apply(src, dst);
+    }
+
     template <typename T>
     void verify_result(array<halo_descriptor, 3> const &halos, T src, T dst) {
         auto src_v = src->const_host_view();
@@ -128,22 +135,39 @@ namespace {
     }
 } // namespace
 
+namespace {
+    template <typename Fixture>
+    void test_boundary(Fixture &fixture, uint_t halo_size) {
+        auto src = fixture.make_storage([](int i, int j, int k) { return i + j + k; });
+        auto dst = fixture.make_storage(0);
+
+        auto &&lengths = src->info().lengths();
+        halo_descriptor di{halo_size, halo_size, halo_size, lengths[0] - halo_size - 1, lengths[0]};
+        halo_descriptor dj{halo_size, halo_size, halo_size, lengths[1] - halo_size - 1, lengths[1]};
+        halo_descriptor dk{halo_size, halo_size, halo_size, lengths[2] - halo_size - 1, lengths[2]};
+        array<halo_descriptor, 3> halos{di, dj, dk};
+
+        apply_boundary(halos, src, dst);
+        verify_result(halos, src, dst);
+
+        fixture.benchmark([&] { apply_boundary(halos, src, dst); }, "halo " + std::to_string(halo_size));
+
+        auto stencil_dst = fixture.make_storage(0);
+        apply_stencil_boundary(halos, src, stencil_dst);
+        verify_result(halos, src, stencil_dst);
+
+        fixture.benchmark([&] { apply_stencil_boundary(halos, src, stencil_dst); },
+            "stencil backend, halo " + std::to_string(halo_size));
+    }
+} // namespace
+
 constexpr auto halo_size = 3;
+constexpr auto small_halo_size = 1;
 
 struct distributed_boundary : cartesian::regression_fixture<halo_size> {};
 
-TEST_F(distributed_boundary, test) {
-    auto src = make_storage([](int i, int j, int k) { return i + j + k; });
-    auto dst = make_storage(0);
-
-    auto &&lengths = src->info().lengths();
-    halo_descriptor di{halo_size, halo_size, halo_size, lengths[0] - halo_size - 1, lengths[0]};
-    halo_descriptor dj{halo_size, halo_size, halo_size, lengths[1] - halo_size - 1, lengths[1]};
-    halo_descriptor dk{halo_size, halo_size, halo_size, lengths[2] - halo_size - 1, lengths[2]};
-    array<halo_descriptor, 3> halos{di, dj, dk};
+TEST_F(distributed_boundary, test) { test_boundary(*this, halo_size); }
 
-    apply_boundary(halos, src, dst);
-    verify_result(halos, src, dst);
+struct distributed_boundary_small_halo : cartesian::regression_fixture<small_halo_size> {};
 
-    benchmark([&] { apply_boundary(halos, src, dst); });
-}
+TEST_F(distributed_boundary_small_halo, test) { test_boundary(*this, small_halo_size); }
@@ -0,0 +1,218 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include <gridtools/common/boollist.hpp>
+#include <gridtools/communication/halo_exchange.hpp>
+
+/** @file
+    @brief Helpers shared by the tests of the modes of halo_exchange_dynamic_ut: two fields are exchanged several
+    times with changing data, every halo point is checked against the global point it replicates, and the number of
+    MPI messages and the time per exchange are measured.
+*/
+
+namespace halo_exchange_3D_modes {
+    using pattern_type = gridtools::halo_exchange_dynamic_ut<gridtools::layout_map<0, 1, 2>,
+        gridtools::layout_map<0, 1, 2>,
+        double,
+        gridtools::gcl_cpu>;
+
+    const int n[3] = {16, 12, 8};
+    const int h[3] = {1, 2, 3};
+    const int total[3] = {n[0] + 2 * h[0], n[1] + 2 * h[1], n[2] + 2 * h[2]};
+    const int steps = 4;
+    const int iterations = 100;
+
+    // value of the halo points outside of the global domain, which no exchange writes
+    const double untouched = 0.5;
+
+    inline int index(int i, int j, int k) { return (i * total[1] + j) * total[2] + k; }
+
+    inline char const *mode_name(gridtools::halo_exchange_mode mode) {
+        switch (mode) {
+        case gridtools::halo_exchange_mode::all_neighbors:
+            return "all_neighbors";
+        case gridtools::halo_exchange_mode::by_dimension:
+            return "by_dimension";
+        case gridtools::halo_exchange_mode::shared_memory:
+            return "shared_memory";
+        case gridtools::halo_exchange_mode::derived_datatypes:
+            return "derived_datatypes";
+        case gridtools::halo_exchange_mode::neighbor_collective:
+            return "neighbor_collective";
+        }
+        return "unknown";
+    }
+
+    /**
+       Cartesian communicator over all the processes. With `along_first` they are all placed along the first
+       dimension, so that along the periodic ones among the other two the neighbors are the process itself.
+    */
+    struct process_grid {
+        gridtools::boollist<3> periodicity;
+        int dims[3] = {0, 0, 0};
+        int period[3];
+        int coords[3];
+        MPI_Comm comm;
+
+        process_grid(bool per0, bool per1, bool per2, bool along_first)
+            : periodicity(per0, per1, per2), period{per0, per1, per2} {
+            int nprocs;
+            MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+            if (along_first) {
+                dims[0] = nprocs;
+                dims[1] = dims[2] = 1;
+            } else
+                MPI_Dims_create(nprocs, 3, dims);
+            MPI_Cart_create(MPI_COMM_WORLD, 3, dims, period, false, &comm);
+            MPI_Cart_get(comm, 3, dims, period, coords);
+        }
+
+        process_grid(process_grid const &) = delete;
+        process_grid &operator=(process_grid const &) = delete;
+
+        ~process_grid() { MPI_Comm_free(&comm); }
+
+        // the value at the given step of the global point replicated by the local point (i, j, k)
+        double expected(int i, int j, int k, int field, int step) const {
+            int local[3] = {i, j, k};
+            int global[3];
+            for (int d = 0; d < 3; ++d) {
+                global[d] = coords[d] * n[d] + local[d] - h[d];
+                if (period[d])
+                    global[d] = (global[d] + dims[d] * n[d]) % (dims[d] * n[d]);
+                else if (global[d] < 0 || global[d] >= dims[d] * n[d])
+                    return untouched;
+            }
+            double value = (global[0] * 1000. + global[1]) * 1000. + global[2] + step;
+            return field == 0 ? value : -value;
+        }
+
+        /**
+           Number of MPI messages a process sends in one exchange in the given mode: one to each neighbor, or to
+           each face neighbor in the by_dimension mode, that exists and is not the process itself. In the
+           shared_memory mode it is an upper bound, the neighbors on the same node are not sent messages.
+        */
+        int messages(gridtools::halo_exchange_mode mode) const {
+            int res = 0;
+            for (int i = -1; i <= 1; ++i)
+                for (int j = -1; j <= 1; ++j)
+                    for (int k = -1; k <= 1; ++k) {
+                        int eta[3] = {i, j, k};
+                        int offsets = 0;
+                        bool exists = true, self = true;
+                        for (int d = 0; d < 3; ++d)
+                            if (eta[d] != 0) {
+                                ++offsets;
+                                exists = exists && (period[d] || (coords[d] + eta[d] >= 0 &&
+                                                                     coords[d] + eta[d] < dims[d]));
+                                self = self && period[d] && dims[d] == 1;
+                            }
+                        if (offsets == 0 || (offsets > 1 && mode == gridtools::halo_exchange_mode::by_dimension))
+                            continue;
+                        res += exists && !self;
+                    }
+            return res;
+        }
+    };
+
+    struct exchange_result {
+        std::vector<double> a, b;
+        bool correct = true;
+        int messages;
+        double time;
+    };
+
+    /**
+       Exchanges the halos of two fields `steps` times in the given mode. The interior points carry the values of
+       the global points and the step, the halos keep the values of the previous step, and are checked after every
+       exchange. The steps cycle over the blocking interface with vectors of fields, the split-phase interface with
+       wait_and_unpack and the split-phase interface with wait and unpack, calling `work()` while the exchange is in
+       flight. The exchanges timed afterwards use copies of the fields, so that a mode cannot rely on seeing the
+       same fields again.
+    */
+    template <typename Work>
+    exchange_result run(process_grid const &grid, gridtools::halo_exchange_mode mode, Work &&work) {
+        pattern_type he(grid.periodicity, grid.comm);
+        he.add_halo<0>(h[0], h[0], h[0], n[0] + h[0] - 1, total[0]);
+        he.add_halo<1>(h[1], h[1], h[1], n[1] + h[1] - 1, total[1]);
+        he.add_halo<2>(h[2], h[2], h[2], n[2] + h[2] - 1, total[2]);
+        he.setup(2, mode);
+
+        exchange_result res;
+        res.a.assign(total[0] * total[1] * total[2], untouched);
+        res.b.assign(total[0] * total[1] * total[2], untouched);
+        double *a = res.a.data();
+        double *b = res.b.data();
+        std::vector<double *> fields = {a, b};
+        for (int step = 0; step < steps; ++step) {
+            for (int i = h[0]; i < n[0] + h[0]; ++i)
+                for (int j = h[1]; j < n[1] + h[1]; ++j)
+                    for (int k = h[2]; k < n[2] + h[2]; ++k) {
+                        a[index(i, j, k)] = grid.expected(i, j, k, 0, step);
+                        b[index(i, j, k)] = grid.expected(i, j, k, 1, step);
+                    }
+            if (step % 3 == 0) {
+                he.pack(fields);
+                he.exchange();
+                he.unpack(fields);
+            } else {
+                he.pack(a, b);
+                he.start_exchange();
+                work();
+                if (step % 3 == 1)
+                    he.wait_and_unpack(a, b);
+                else {
+                    he.wait();
+                    he.unpack(a, b);
+                }
+            }
+            for (int i = 0; i < total[0]; ++i)
+                for (int j = 0; j < total[1]; ++j)
+                    for (int k = 0; k < total[2]; ++k)
+                        res.correct = res.correct && a[index(i, j, k)] == grid.expected(i, j, k, 0, step) &&
+                                      b[index(i, j, k)] == grid.expected(i, j, k, 1, step);
+        }
+        res.messages = he.message_count();
+
+        std::vector<double> a_copy = res.a, b_copy = res.b;
+        std::vector<double *> copies = {a_copy.data(), b_copy.data()};
+        MPI_Barrier(grid.comm);
+        res.time = MPI_Wtime();
+        for (int t = 0; t < iterations; ++t) {
+            he.pack(copies);
+            he.start_exchange();
+            work();
+            he.wait_and_unpack(copies);
+        }
+        res.time = (MPI_Wtime() - res.time) / iterations;
+        return res;
+    }
+
+    inline exchange_result run(process_grid const &grid, gridtools::halo_exchange_mode mode) {
+        return run(grid, mode, [] {});
+    }
+
+    // prints, on the first process, the messages sent by all the processes and the slowest time per exchange
+    inline void report(process_grid const &grid, std::string const &name, exchange_result const &res) {
+        int messages;
+        MPI_Reduce(&res.messages, &messages, 1, MPI_INT, MPI_SUM, 0, grid.comm);
+        double time;
+        MPI_Reduce(&res.time, &time, 1, MPI_DOUBLE, MPI_MAX, 0, grid.comm);
+        if (gridtools::PID == 0)
+            std::cout << "  " << name << ": " << messages << " MPI messages, " << time * 1e6 << " us per exchange\n";
+    }
+} // namespace halo_exchange_3D_modes
@@ -42,6 +42,7 @@ namespace halo_exchange_3D_all {
     double lapse_time1;
     double lapse_time2;
     double lapse_time3;
+    gridtools::halo_exchange_mode mode;
 
 #define B_ADD 1
 #define C_ADD 2
@@ -122,7 +123,7 @@ namespace halo_exchange_3D_all {
            parameter must me greater or equal to the largest number of
            arrays updated in a single step.
         */
-        he.setup(3);
+        he.setup(3, mode);
 
         file << "Proc: (" << coords[0] << ", " << coords[1] << ", " << coords[2] << ")\n";
         file.flush();
@@ -342,7 +343,14 @@ namespace halo_exchange_3D_all {
         the H width border is the inner region of an hypothetical stencil
         computation whise halo width is H.
     */
-    bool test(int DIM1, int DIM2, int DIM3, int H, int P0 = 0, int P1 = 0) {
+    bool test(int DIM1,
+        int DIM2,
+        int DIM3,
+        int H,
+        int P0 = 0,
+        int P1 = 0,
+        gridtools::halo_exchange_mode exchange_mode = gridtools::halo_exchange_mode::all_neighbors) {
+        mode = exchange_mode;
         /* Here we compute the computing gris as in many applications
          */
         MPI_Comm_rank(MPI_COMM_WORLD, &pid);
@@ -359,6 +367,7 @@ namespace halo_exchange_3D_all {
         std::ofstream file(filename.c_str());
 
         file << pid << "  " << nprocs << "\n";
+        file << "neighbor collective: " << (mode == gridtools::halo_exchange_mode::neighbor_collective) << "\n";
 
         dims[0] = P0;
         dims[1] = P1;
@@ -640,4 +649,12 @@ TEST(Communication, test_halo_exchange_3D_all) {
     bool passed = halo_exchange_3D_all::test(12, 12, 12, 2, 2, 1);
     EXPECT_TRUE(passed);
 }
+
+#ifndef __CUDACC__
+TEST(Communication, test_halo_exchange_3D_all_neighbor_collective) {
+    bool passed =
+        halo_exchange_3D_all::test(12, 12, 12, 2, 2, 1, gridtools::halo_exchange_mode::neighbor_collective);
+    EXPECT_TRUE(passed);
+}
+#endif
 #endif
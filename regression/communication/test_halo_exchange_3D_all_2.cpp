@@ -620,6 +620,13 @@ namespace halo_exchange_3D_all_2 {
 
 #ifdef GCL_TRACE
         gridtools::stats_collector_3D.evaluate(std::cout);
+        // the traces are written to memory, so that the test leaves no files behind
+        std::ostringstream trace;
+        gridtools::stats_collector_3D.export_chrome_trace(trace);
+        passed = passed && trace.str().find("\"cat\":\"mpi\"") != std::string::npos;
+        std::ostringstream binary_trace;
+        gridtools::stats_collector_3D.export_binary(binary_trace);
+        passed = passed && binary_trace.str().compare(0, 4, "GCLT") == 0;
 #endif
 
         delete[] _a;
@@ -0,0 +1,71 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/tools/mpi_unit_test_driver/check_flags.hpp>
+
+#include "halo_exchange_3D_modes.hpp"
+
+/** @file
+    @brief Compares each mode of halo_exchange_dynamic_ut against the exchange with all the neighbors, with periodic,
+    non periodic and mixed boundaries, on a process grid created by MPI_Dims_create and on one with all the processes
+    along the first dimension, where the periodic neighbors along the other dimensions are the process itself. Both
+    modes have to produce the expected halos and to send one MPI message to each neighbor, or each face neighbor in
+    the by_dimension mode, that is not the process itself; in the shared_memory mode the neighbors on the same node
+    are not sent messages at all.
+*/
+
+namespace halo_exchange_3D_modes {
+    bool test(gridtools::halo_exchange_mode mode) {
+        bool passed = true;
+        const bool periodicities[3][3] = {{true, true, true}, {false, false, false}, {true, false, true}};
+        for (bool along_first : {false, true})
+            for (auto const &per : periodicities) {
+                process_grid grid(per[0], per[1], per[2], along_first);
+                exchange_result all = run(grid, gridtools::halo_exchange_mode::all_neighbors);
+                exchange_result res = run(grid, mode);
+
+                passed = passed && all.correct && res.correct;
+                passed = passed && all.messages == grid.messages(gridtools::halo_exchange_mode::all_neighbors);
+                passed = passed && (mode == gridtools::halo_exchange_mode::shared_memory
+                                           ? res.messages <= grid.messages(mode)
+                                           : res.messages == grid.messages(mode));
+
+                if (gridtools::PID == 0)
+                    std::cout << "process grid " << grid.dims[0] << "x" << grid.dims[1] << "x" << grid.dims[2]
+                              << ", periodicity " << per[0] << per[1] << per[2] << "\n";
+                report(grid, mode_name(gridtools::halo_exchange_mode::all_neighbors), all);
+                report(grid, mode_name(mode), res);
+            }
+        return passed;
+    }
+} // namespace halo_exchange_3D_modes
+
+TEST(Communication, test_halo_exchange_3D_by_dimension) {
+    bool passed = halo_exchange_3D_modes::test(gridtools::halo_exchange_mode::by_dimension);
+    EXPECT_TRUE(passed);
+}
+
+TEST(Communication, test_halo_exchange_3D_shared_memory) {
+    bool passed = halo_exchange_3D_modes::test(gridtools::halo_exchange_mode::shared_memory);
+    EXPECT_TRUE(passed);
+}
+
+TEST(Communication, test_halo_exchange_3D_derived_datatypes) {
+    bool passed = halo_exchange_3D_modes::test(gridtools::halo_exchange_mode::derived_datatypes);
+    EXPECT_TRUE(passed);
+}
+
+TEST(Communication, test_halo_exchange_3D_neighbor_collective) {
+    bool passed = halo_exchange_3D_modes::test(gridtools::halo_exchange_mode::neighbor_collective);
+    EXPECT_TRUE(passed);
+}
@@ -0,0 +1,80 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <gridtools/tools/mpi_unit_test_driver/check_flags.hpp>
+
+#include "halo_exchange_3D_modes.hpp"
+
+/** @file
+    @brief Compares the halo exchange progressed by the dedicated communication thread against the one progressed
+    inside the MPI calls. Computation on unrelated data runs between start_exchange and wait. The time per exchange
+    of the two modes is reported. Needs MPI_THREAD_MULTIPLE.
+*/
+
+namespace halo_exchange_3D_progress_thread {
+    using namespace halo_exchange_3D_modes;
+
+    // stands for the stencils that do not need the halos being exchanged
+    double compute(std::vector<double> &work) {
+        double sum = 0;
+        for (int t = 0; t < 10; ++t)
+            for (std::size_t i = 1; i < work.size(); ++i) {
+                work[i] = 0.5 * (work[i] + work[i - 1]);
+                sum += work[i];
+            }
+        return sum;
+    }
+
+    bool test(bool per0, bool per1, bool per2) {
+        process_grid grid(per0, per1, per2, false);
+        std::vector<double> work(total[0] * total[1] * total[2], 1);
+        auto exchange = [&] {
+            return run(grid, gridtools::halo_exchange_mode::all_neighbors, [&] { compute(work); });
+        };
+
+        exchange_result in_calls = exchange();
+
+        int omp_threads = omp_get_max_threads();
+        gridtools::GCL_Init(0, nullptr, gridtools::gcl_progress::dedicated_thread);
+        bool running = gridtools::_impl::progress_thread::instance().running();
+        // the thread takes one core from the OpenMP team
+        bool passed = !running || omp_threads == 1 || omp_get_max_threads() == omp_threads - 1;
+        exchange_result in_thread = exchange();
+        gridtools::_impl::progress_thread::instance().stop();
+        passed = passed && omp_get_max_threads() == omp_threads;
+
+        passed = passed && in_calls.correct && in_thread.correct;
+
+        if (gridtools::PID == 0)
+            std::cout << "periodicity " << per0 << per1 << per2 << "\n";
+        report(grid, "progress in MPI calls", in_calls);
+        report(grid, running ? "progress thread" : "progress thread (absent)", in_thread);
+        return passed;
+    }
+} // namespace halo_exchange_3D_progress_thread
+
+TEST(Communication, test_halo_exchange_3D_progress_thread_periodic) {
+    bool passed = halo_exchange_3D_progress_thread::test(true, true, true);
+    EXPECT_TRUE(passed);
+}
+
+TEST(Communication, test_halo_exchange_3D_progress_thread_non_periodic) {
+    bool passed = halo_exchange_3D_progress_thread::test(false, false, false);
+    EXPECT_TRUE(passed);
+}
+
+TEST(Communication, test_halo_exchange_3D_progress_thread_mixed) {
+    bool passed = halo_exchange_3D_progress_thread::test(true, false, true);
+    EXPECT_TRUE(passed);
+}
@@ -38,5 +38,19 @@ TEST_F(copy_stencil, test) {
     };
     comp();
     verify(in, out);
-    benchmark(comp);
+    benchmark(comp, "run");
+}
+
+TEST_F(copy_stencil, computation) {
+    auto in = [](int i, int j, int k) { return i + j + k; };
+    auto in_s = make_storage<float_type const>(in);
+    auto out = make_storage();
+    auto comp = make_computation([](auto in, auto out) { return execute_parallel().stage(copy_functor(), in, out); },
+        backend_t(),
+        make_grid(),
+        in_s,
+        out);
+    comp();
+    verify(in, out);
+    benchmark(comp, "computation");
 }
@@ -0,0 +1,127 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/communication/halo_exchange.hpp>
+#include <gridtools/communication/low_level/proc_grids_3D.hpp>
+#include <gridtools/stencil_composition/cartesian.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/sid.hpp>
+#include <gridtools/tools/backend_select.hpp>
+#include <gridtools/tools/mpi_unit_test_driver/check_flags.hpp>
+
+/** @file
+    @brief Diffusion time steps on a periodic, distributed domain with the halo exchange overlapped with the
+    computation of the interior (`run_overlapped`) compared against the strictly serial exchange-then-compute steps.
+*/
+
+using namespace gridtools;
+using namespace cartesian;
+
+namespace {
+    struct diffusion_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+        using param_list = make_param_list<out, in>;
+
+        template <typename Evaluation>
+        GT_FUNCTION static void apply(Evaluation &eval) {
+            eval(out()) = eval(in()) +
+                          .1 * (eval(in(1, 0)) + eval(in(-1, 0)) + eval(in(0, 1)) + eval(in(0, -1)) - 4 * eval(in()));
+        }
+    };
+
+    const auto spec = [](auto out, auto in) { return execute_parallel().stage(diffusion_functor(), out, in); };
+
+    using pattern_type = halo_exchange_dynamic_ut<storage::traits::layout_type<storage_traits_t, 3>,
+        layout_map<0, 1, 2>,
+        float_type,
+        gcl_arch_t>;
+
+    TEST(diffusion_parallel_overlap, test) {
+        // the halo exchange assumes unpadded strides, so the total lengths are rounded up to multiples of the
+        // storage alignment, counted in elements
+        const int alignment = std::max<int>(1, storage::traits::alignment<storage_traits_t> / sizeof(float_type));
+        auto aligned = [=](int length) { return (length + alignment - 1) / alignment * alignment; };
+        const int halo = 1, steps = 20;
+        const int d1 = aligned(126 + 2 * halo) - 2 * halo, d2 = aligned(126 + 2 * halo) - 2 * halo, d3 = aligned(40);
+
+        MPI_Comm CartComm;
+        array<int, 3> dimensions{0, 0, 1};
+        int period[3] = {1, 1, 1};
+        MPI_Dims_create(PROCS, 2, &dimensions[0]);
+        MPI_Cart_create(MPI_COMM_WORLD, 3, &dimensions[0], period, false, &CartComm);
+
+        pattern_type he(boollist<3>(true, true, false), CartComm);
+        he.add_halo<0>(halo, halo, halo, d1 + halo - 1, d1 + 2 * halo);
+        he.add_halo<1>(halo, halo, halo, d2 + halo - 1, d2 + 2 * halo);
+        he.add_halo<2>(0, 0, 0, d3 - 1, d3);
+        he.setup(1);
+
+        int pi, pj, pk;
+        he.comm().coords(pi, pj, pk);
+
+        auto builder =
+            storage::builder<storage_traits_t>.type<float_type>().dimensions(d1 + 2 * halo, d2 + 2 * halo, d3);
+        auto initial = [&](int i, int j, int k) {
+            int I = i - halo + d1 * pi;
+            int J = j - halo + d2 * pj;
+            return (I * 7 + J * 13 + k) % 17;
+        };
+        auto grid = make_grid({halo, halo, halo, d1 + halo - 1, d1 + 2 * halo},
+            {halo, halo, halo, d2 + halo - 1, d2 + 2 * halo},
+            d3);
+
+        // serial: exchange, then compute
+        auto in = builder.initializer(initial)();
+        auto out = builder();
+        for (int t = 0; t < steps; ++t) {
+            std::vector<float_type *> fields = {in->get_target_ptr()};
+            he.pack(fields);
+            he.exchange();
+            he.unpack(fields);
+            run(spec, backend_t(), grid, out, in);
+            std::swap(in, out);
+        }
+
+        // overlapped: the interior is computed while the halos are in flight
+        auto in_overlap = builder.initializer(initial)();
+        auto out_overlap = builder();
+        for (int t = 0; t < steps; ++t) {
+            std::vector<float_type *> fields = {in_overlap->get_target_ptr()};
+            run_overlapped(
+                spec,
+                backend_t(),
+                grid,
+                [&] {
+                    he.pack(fields);
+                    he.start_exchange();
+                },
+                [&] {
+                    he.wait();
+                    he.unpack(fields);
+                },
+                out_overlap,
+                in_overlap);
+            std::swap(in_overlap, out_overlap);
+        }
+
+        auto expected = in->const_host_view();
+        auto actual = in_overlap->const_host_view();
+        for (int i = halo; i < d1 + halo; ++i)
+            for (int j = halo; j < d2 + halo; ++j)
+                for (int k = 0; k < d3; ++k)
+                    ASSERT_EQ(expected(i, j, k), actual(i, j, k)) << "i = " << i << ", j = " << j << ", k = " << k;
+    }
+} // namespace
@@ -0,0 +1,52 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/backend/mc.hpp>
+#include <gridtools/stencil_composition/cartesian.hpp>
+#include <gridtools/stencil_composition/global_parameter.hpp>
+#include <gridtools/tools/cartesian_regression_fixture.hpp>
+
+#include "vertical_advection_repository.hpp"
+#include "vertical_advection_stencil.hpp"
+
+/*
+  Compares the tail latency of the vertical advection stencil with the static and dynamic block scheduling policies
+  of the mc backend.
+  */
+
+struct mc_schedule : regression_fixture<3, axis_t> {
+    template <class Schedule>
+    void test(std::string const &name) const {
+        vertical_advection_repository repo{d(0), d(1), d(2)};
+        storage_type utens_stage = make_storage(repo.utens_stage_in);
+        auto comp = [grid = make_grid(),
+                        &utens_stage,
+                        u_stage = make_storage(repo.u_stage),
+                        wcon = make_storage(repo.wcon),
+                        u_pos = make_storage(repo.u_pos),
+                        utens = make_storage(repo.utens),
+                        dtr_stage = make_global_parameter((float_type)repo.dtr_stage)] {
+            run(vertical_advection, mc::backend<Schedule>(), grid, utens_stage, u_stage, wcon, u_pos, utens, dtr_stage);
+        };
+        comp();
+        verify(repo.utens_stage_out, utens_stage);
+        benchmark_latency(comp, name);
+    }
+};
+
+TEST_F(mc_schedule, static_schedule) { test<mc::static_schedule>("static"); }
+
+TEST_F(mc_schedule, dynamic_schedule) { test<mc::dynamic_schedule<>>("dynamic"); }
+
+TEST_F(mc_schedule, dynamic_schedule_fine) { test<mc::dynamic_schedule<16>>("dynamic_fine"); }
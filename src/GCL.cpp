@@ -8,6 +8,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <gridtools/communication/GCL.hpp>
+#ifdef GCL_MPI
+#include <gridtools/communication/low_level/progress_thread.hpp>
+#endif
 
 #ifdef GCL_GPU
 #ifdef GCL_MULTI_STREAMS
@@ -36,16 +39,31 @@ namespace gridtools {
     int PROCS;
 
     namespace _impl {
-        void GCL_Real_Init(int argc, char **argv) {
+        void GCL_Real_Init(int argc, char **argv, gcl_progress progress) {
             int ready;
             MPI_Initialized(&ready);
-            if (!ready)
-                MPI_Init(&argc, &argv);
+            int provided;
+            if (!ready) {
+                // only the master thread of the OpenMP team calls MPI, unless the progress thread does too
+                int required =
+                    progress == gcl_progress::dedicated_thread ? MPI_THREAD_MULTIPLE : MPI_THREAD_FUNNELED;
+                MPI_Init_thread(&argc, &argv, required, &provided);
+            } else
+                MPI_Query_thread(&provided);
 
             GCL_WORLD = MPI_COMM_WORLD;
             MPI_Comm_rank(GCL_WORLD, &PID);
             MPI_Comm_size(GCL_WORLD, &PROCS);
 
+            if (progress == gcl_progress::dedicated_thread) {
+                if (provided == MPI_THREAD_MULTIPLE)
+                    progress_thread::instance().start();
+                else if (PID == 0)
+                    std::cerr << "GCL: MPI does not provide MPI_THREAD_MULTIPLE, the communication progress thread "
+                                 "is not started"
+                              << std::endl;
+            }
+
 #ifdef GCL_MULTI_STREAMS
 #ifdef GCL_USE_3
             GT_CUDA_CHECK(cudaStreamCreate(&ZL_stream));
@@ -63,14 +81,17 @@ namespace gridtools {
         }
     } // namespace _impl
 
-    void GCL_Init(int argc, char **argv) { _impl::GCL_Real_Init(argc, argv); }
+    void GCL_Init(int argc, char **argv) { _impl::GCL_Real_Init(argc, argv, gcl_progress::in_mpi_calls); }
+
+    void GCL_Init(int argc, char **argv, gcl_progress progress) { _impl::GCL_Real_Init(argc, argv, progress); }
 
     void GCL_Init() {
         int arg = 1;
-        _impl::GCL_Real_Init(arg, 0);
+        _impl::GCL_Real_Init(arg, 0, gcl_progress::in_mpi_calls);
     }
 
     void GCL_Finalize() {
+        _impl::progress_thread::instance().stop();
 #ifdef GCL_MULTI_STREAMS
 #ifdef GCL_USE_3
         GT_CUDA_CHECK(cudaStreamDestroy(ZL_stream));
@@ -89,14 +110,6 @@ namespace gridtools {
     }
 
 #ifdef GCL_TRACE
-    // initialize static instance_ to nullptr
-    template <>
-    stats_collector<1> *stats_collector<1>::instance_ = 0;
-    template <>
-    stats_collector<2> *stats_collector<2>::instance_ = 0;
-    template <>
-    stats_collector<3> *stats_collector<3>::instance_ = 0;
-
     // convenient handles for the singleton instances for 2D and 3D grids
     stats_collector<3> &stats_collector_3D = *stats_collector<3>::instance();
     stats_collector<2> &stats_collector_2D = *stats_collector<2>::instance();
@@ -111,6 +124,8 @@ namespace gridtools {
         PID = 0;
     }
 
+    void GCL_Init(int argc, char **argv, gcl_progress) { GCL_Init(argc, argv); }
+
     void GCL_Init() {
         PROCS = 1;
         PID = 0;
@@ -0,0 +1,147 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/boundary_conditions/stencil_boundary.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/boundary_conditions/boundary.hpp>
+#include <gridtools/boundary_conditions/copy.hpp>
+#include <gridtools/boundary_conditions/value.hpp>
+#include <gridtools/boundary_conditions/zero.hpp>
+#include <gridtools/common/halo_descriptor.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/tools/backend_select.hpp>
+
+using namespace gridtools;
+
+namespace {
+    struct bc_direction {
+        template <sign I, sign J, sign K, typename DataField0, typename DataField1>
+        GT_FUNCTION void operator()(direction<I, J, K>,
+            DataField0 &data_field0,
+            DataField1 const &data_field1,
+            uint_t i,
+            uint_t j,
+            uint_t k) const {
+            data_field0(i, j, k) = data_field1(i, j, k) + (I + 2) * 100 + (J + 2) * 10 + K + 2;
+        }
+    };
+
+    // reads the neighbor of the current point towards the compute domain in k
+    struct bc_neighbor {
+        template <sign I, sign J, sign K, typename DataField0, typename DataField1>
+        GT_FUNCTION void operator()(direction<I, J, K>,
+            DataField0 &data_field0,
+            DataField1 const &data_field1,
+            uint_t i,
+            uint_t j,
+            uint_t k) const {
+            data_field0(i, j, k) = data_field1(i, j, k - K) + 1;
+        }
+    };
+
+    struct not_minus_predicate {
+        template <sign I, sign J, sign K>
+        bool operator()(direction<I, J, K>) const {
+            return !(I == minus_ || J == minus_ || K == minus_);
+        }
+    };
+
+    const uint_t d1 = 9;
+    const uint_t d2 = 8;
+    const uint_t d3 = 10;
+
+    // asymmetric halos, with points outside of the halo in j and k
+    array<halo_descriptor, 3> make_halos() {
+        array<halo_descriptor, 3> halos;
+        halos[0] = halo_descriptor(2, 1, 2, d1 - 2, d1);
+        halos[1] = halo_descriptor(1, 2, 2, d2 - 4, d2);
+        halos[2] = halo_descriptor(1, 3, 2, d3 - 5, d3);
+        return halos;
+    }
+
+    auto make_storage(int_t offset) {
+        return storage::builder<storage_traits_t>
+            .type<float_type>()
+            .dimensions(d1, d2, d3)
+            .initializer([offset](int i, int j, int k) { return offset + i * 10000 + j * 100 + k; })
+            .build();
+    }
+
+    template <class Reference, class Actual>
+    void expect_equal(Reference const &reference, Actual const &actual) {
+        auto ref = reference->const_host_view();
+        auto act = actual->const_host_view();
+        for (uint_t i = 0; i < d1; ++i)
+            for (uint_t j = 0; j < d2; ++j)
+                for (uint_t k = 0; k < d3; ++k)
+                    EXPECT_EQ(ref(i, j, k), act(i, j, k)) << i << ", " << j << ", " << k;
+    }
+} // namespace
+
+TEST(stencil_boundary, direction) {
+    auto ref = make_storage(0);
+    auto src = make_storage(1000000);
+    auto out = make_storage(0);
+
+    boundary<bc_direction, gcl_arch_t>(make_halos(), bc_direction()).apply(ref, src);
+    make_stencil_boundary<backend_t>(make_halos(), bc_direction()).apply(out, src);
+    expect_equal(ref, out);
+}
+
+TEST(stencil_boundary, predicate) {
+    auto ref = make_storage(0);
+    auto src = make_storage(1000000);
+    auto out = make_storage(0);
+
+    boundary<bc_direction, gcl_arch_t, not_minus_predicate>(make_halos(), bc_direction(), not_minus_predicate())
+        .apply(ref, src);
+    make_stencil_boundary<backend_t>(make_halos(), bc_direction(), not_minus_predicate()).apply(out, src);
+    expect_equal(ref, out);
+}
+
+TEST(stencil_boundary, value_copy_zero) {
+    auto ref0 = make_storage(0);
+    auto ref1 = make_storage(1);
+    auto ref2 = make_storage(2);
+    auto out0 = make_storage(0);
+    auto out1 = make_storage(1);
+    auto out2 = make_storage(2);
+
+    boundary<value_boundary<float_type>, gcl_arch_t>(make_halos(), value_boundary<float_type>(3.5))
+        .apply(ref0, ref1, ref2);
+    make_stencil_boundary<backend_t>(make_halos(), value_boundary<float_type>(3.5)).apply(out0, out1, out2);
+    expect_equal(ref0, out0);
+    expect_equal(ref1, out1);
+    expect_equal(ref2, out2);
+
+    auto src = make_storage(1000000);
+    boundary<copy_boundary, gcl_arch_t>(make_halos(), copy_boundary()).apply(ref0, ref1, src);
+    make_stencil_boundary<backend_t>(make_halos(), copy_boundary()).apply(out0, out1, src);
+    expect_equal(ref0, out0);
+    expect_equal(ref1, out1);
+
+    boundary<zero_boundary, gcl_arch_t>(make_halos(), zero_boundary()).apply(ref2);
+    make_stencil_boundary<backend_t>(make_halos(), zero_boundary()).apply(out2);
+    expect_equal(ref2, out2);
+}
+
+TEST(stencil_boundary, extent) {
+    auto ref = make_storage(0);
+    auto src = make_storage(1000000);
+    auto out = make_storage(0);
+
+    boundary<bc_neighbor, gcl_arch_t>(make_halos(), bc_neighbor()).apply(ref, src);
+    stencil_boundary<bc_neighbor, backend_t, default_predicate, extent<0, 0, 0, 0, -1, 1>>(
+        make_halos(), bc_neighbor())
+        .apply(out, src);
+    expect_equal(ref, out);
+}
@@ -0,0 +1,49 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/common/numa.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hugepage_alloc.hpp>
+
+namespace gridtools {
+    namespace {
+
+        TEST(numa, first_touch) {
+            std::size_t n = 1 << 20;
+
+            int *ptr = static_cast<int *>(hugepage_alloc(n * sizeof(int)));
+            numa_first_touch(ptr, n * sizeof(int));
+
+            // where the placement can be queried, every page has been placed on a node by the touch
+            if (numa_node(ptr) != -1) {
+                for (std::size_t i = 0; i < n; i += 4096 / sizeof(int))
+                    EXPECT_GE(numa_node(ptr + i), 0) << i;
+            }
+
+            for (std::size_t i = 0; i < n; ++i) {
+                ptr[i] = i;
+                EXPECT_EQ(ptr[i], i);
+            }
+
+            hugepage_free(ptr);
+        }
+
+        TEST(numa, touch_preserves_bounds) {
+            char buffer[3 * 4096] = {};
+            buffer[99] = 1;
+            buffer[3 * 4096 - 1] = 1;
+            numa_touch(buffer + 100, 3 * 4096 - 101);
+            EXPECT_EQ(buffer[99], 1);
+            EXPECT_EQ(buffer[3 * 4096 - 1], 1);
+        }
+
+    } // namespace
+} // namespace gridtools
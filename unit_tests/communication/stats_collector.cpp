@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/communication/high_level/stats_collector.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+
+namespace gridtools {
+    namespace {
+        template <typename T>
+        T read_raw(std::istream &stream) {
+            T res;
+            stream.read(reinterpret_cast<char *>(&res), sizeof(T));
+            return res;
+        }
+
+        bool contains(std::string const &str, std::string const &sub) { return str.find(sub) != std::string::npos; }
+
+        TEST(event_ring, overwrites_oldest) {
+            event_ring<int> ring(3);
+            for (int i = 0; i < 5; ++i)
+                ring.push_back(i);
+            EXPECT_EQ(ring.size(), 3);
+            EXPECT_EQ(ring.dropped(), 2);
+            int expected = 2;
+            for (auto it = ring.begin(); it != ring.end(); ++it)
+                EXPECT_EQ(*it, expected++);
+            EXPECT_EQ(expected, 5);
+
+            ring.reset(1);
+            EXPECT_EQ(ring.size(), 0);
+            EXPECT_EQ(ring.dropped(), 0);
+        }
+
+        TEST(stats_collector, export_trace) {
+            int rank, size;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+            stats_collector<3> &collector = *stats_collector<3>::instance();
+            collector.init(MPI_COMM_WORLD);
+            collector.set_capacity(2, 1);
+            collector.recording(true);
+            double t = MPI_Wtime();
+            // the first exchange event and the first MPI event are overwritten
+            collector.add_event(ExchangeEvent(ee_pack, t, t + 1e-6, 2, 0));
+            collector.add_event(ExchangeEvent(ee_start_exchange, t + 1e-6, t + 3e-6, 2, 0));
+            collector.add_event(ExchangeEvent(ee_wait, t + 5e-6, t + 9e-6, 3, 1));
+            collector.add_event(CommEvent(ce_send, 1, 5, 64, t, t + 1e-6, 0));
+            collector.add_event(CommEvent(ce_receive, 2, 7, 128, t + 2e-6, t + 4e-6, 1));
+            collector.recording(false);
+            collector.add_event(CommEvent(ce_send_wait, 3, 9, 256, t, t + 1e-6, 0));
+
+            std::stringstream json;
+            collector.export_chrome_trace(json);
+            std::string trace = json.str();
+            EXPECT_TRUE(contains(trace, "\"rank\":" + std::to_string(rank) + ",\"size\":" + std::to_string(size)));
+            EXPECT_TRUE(contains(trace, "\"dropped_exchange_events\":1,\"dropped_events\":1"));
+            EXPECT_FALSE(contains(trace, "\"name\":\"pack\""));
+            EXPECT_FALSE(contains(trace, "\"name\":\"send\""));
+            EXPECT_FALSE(contains(trace, "\"name\":\"send_wait\""));
+            EXPECT_TRUE(contains(trace, "\"name\":\"start exchg\",\"cat\":\"exchange\",\"ph\":\"X\""));
+            EXPECT_TRUE(contains(trace, "\"dur\":2.000,\"args\":{\"pattern\":0,\"fields\":2}}"));
+            EXPECT_TRUE(contains(trace, "\"name\":\"wait\",\"cat\":\"exchange\""));
+            EXPECT_TRUE(contains(trace, "\"dur\":4.000,\"args\":{\"pattern\":1,\"fields\":3}}"));
+            EXPECT_TRUE(contains(trace, "\"name\":\"receive\",\"cat\":\"mpi\",\"ph\":\"X\""));
+            EXPECT_TRUE(contains(trace, "\"args\":{\"pattern\":1,\"other_rank\":2,\"tag\":7,\"size\":128}}"));
+            EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+
+            std::stringstream binary;
+            collector.export_binary(binary);
+            char magic[4];
+            binary.read(magic, 4);
+            EXPECT_EQ(std::string(magic, 4), "GCLT");
+            EXPECT_EQ(read_raw<std::uint32_t>(binary), 1);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), rank);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), size);
+            double t0 = read_raw<double>(binary);
+            EXPECT_LE(t0, t);
+            EXPECT_EQ(read_raw<std::uint64_t>(binary), 2);
+            EXPECT_EQ(read_raw<std::uint64_t>(binary), 1);
+            EXPECT_EQ(read_raw<std::uint64_t>(binary), 1);
+            EXPECT_EQ(read_raw<std::uint64_t>(binary), 1);
+
+            EXPECT_EQ(read_raw<std::int32_t>(binary), ee_start_exchange);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 0);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 2);
+            EXPECT_EQ(read_raw<double>(binary), t + 1e-6 - t0);
+            EXPECT_EQ(read_raw<double>(binary), t + 3e-6 - t0);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), ee_wait);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 1);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 3);
+            EXPECT_EQ(read_raw<double>(binary), t + 5e-6 - t0);
+            EXPECT_EQ(read_raw<double>(binary), t + 9e-6 - t0);
+
+            EXPECT_EQ(read_raw<std::int32_t>(binary), ce_receive);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 1);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 2);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 7);
+            EXPECT_EQ(read_raw<std::int32_t>(binary), 128);
+            EXPECT_EQ(read_raw<double>(binary), t + 2e-6 - t0);
+            EXPECT_EQ(read_raw<double>(binary), t + 4e-6 - t0);
+
+            binary.peek();
+            EXPECT_TRUE(binary.eof());
+        }
+    } // namespace
+} // namespace gridtools
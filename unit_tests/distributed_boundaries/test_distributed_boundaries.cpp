@@ -474,3 +474,142 @@ TEST(DistributedBoundaries, Test) {
 
     EXPECT_THROW(cabc.exchange(a, b, c, d), std::runtime_error);
 }
+
+namespace {
+    using namespace gridtools;
+
+    /*
+      Setup shared by the tests of the variants of the exchange: two storages of triplets with halos of 2 along i
+      and j, exchanged periodically along i on a 3D process grid, one of them with a value boundary condition. The
+      interior points carry the global coordinates of the point, the halos are initialized with zeros.
+    */
+    class DistributedBoundariesExchange : public testing::Test {
+      protected:
+        static constexpr int halo_size = 2;
+        static constexpr int d1 = 6;
+        static constexpr int d2 = 7;
+        static constexpr int d3 = 2;
+#ifdef GCL_MPI
+        // the halos along i are exchanged even with a single process along i
+        static constexpr bool periodic_i = true;
+#else
+        // without MPI the communication cannot be periodic
+        static constexpr bool periodic_i = false;
+#endif
+
+        using builder_t = decltype(
+            storage::builder<storage_traits_t>.type<triplet>().halos(2, 2, 0).dimensions(d1, d2, d3));
+        using storage_type = decltype(std::declval<builder_t>()());
+        using cabc_t = distributed_boundaries<comm_traits<storage_type, gcl_arch_t, timer_impl_t>>;
+
+        builder_t builder =
+            storage::builder<storage_traits_t>.type<triplet>().halos(2, 2, 0).dimensions(d1, d2, d3);
+        cabc_t cabc;
+        int pi, pj, pk;
+        int PI, PJ, PK;
+
+        static MPI_Comm cart_comm() {
+#ifdef GCL_MPI
+            int dims[3] = {0, 0, 0};
+            MPI_Dims_create(PROCS, 3, dims);
+            int period[3] = {1, 1, 1};
+            MPI_Comm res;
+            MPI_Cart_create(GCL_WORLD, 3, dims, period, false, &res);
+            return res;
+#else
+            return GCL_WORLD;
+#endif
+        }
+
+        static array<halo_descriptor, 3> halos() {
+            return {halo_descriptor{halo_size, halo_size, halo_size, d1 - halo_size - 1, d1},
+                halo_descriptor{halo_size, halo_size, halo_size, d2 - halo_size - 1, d2},
+                halo_descriptor{0, 0, 0, d3 - 1, d3}};
+        }
+
+        DistributedBoundariesExchange() : cabc{halos(), {periodic_i, false, false}, 2, cart_comm()} {
+            cabc.proc_grid().coords(pi, pj, pk);
+            cabc.proc_grid().dims(PI, PJ, PK);
+        }
+
+        // the value of the global point replicated by the local point (i, j, k)
+        triplet value(int i, int j, int k) const {
+            int ni = PI * (d1 - 2 * halo_size);
+            int gi = (pi * (d1 - 2 * halo_size) + i - halo_size + ni) % ni;
+            int gj = pj * (d2 - 2 * halo_size) + j - halo_size;
+            return triplet{gi + 1, gj + 1, pk * d3 + k + 1};
+        }
+
+        storage_type make_storage() const {
+            return builder.initializer([this](int i, int j, int k) {
+                bool inner = region(i, d1, halo_size) == 0 and region(j, d2, halo_size) == 0;
+                return inner ? value(i, j, k) : triplet{0, 0, 0};
+            })();
+        }
+
+        /*
+          The value expected after the exchange: the halos received from a neighbor replicate its interior, the
+          other ones are set by the boundary condition, if any, or left untouched.
+        */
+        triplet expected(int i, int j, int k, bool value_bc) const {
+            int ri = region(i, d1, halo_size);
+            int rj = region(j, d2, halo_size);
+            if ((ri == 0 and rj == 0) or from_neighbor(ri, rj, 0, cabc.proc_grid()))
+                return value(i, j, k);
+            return value_bc ? triplet{42, 42, 42} : triplet{0, 0, 0};
+        }
+
+        void check(storage_type const &a, storage_type const &b) const {
+            auto a_view = a->host_view();
+            auto b_view = b->host_view();
+            for (int i = 0; i < d1; ++i)
+                for (int j = 0; j < d2; ++j)
+                    for (int k = 0; k < d3; ++k) {
+                        EXPECT_EQ(a_view(i, j, k), expected(i, j, k, false)) << i << ", " << j << ", " << k;
+                        EXPECT_EQ(b_view(i, j, k), expected(i, j, k, true)) << i << ", " << j << ", " << k;
+                    }
+        }
+    };
+
+    TEST_F(DistributedBoundariesExchange, Exchange) {
+        auto a = make_storage();
+        auto b = make_storage();
+        cabc.exchange(a, bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, b));
+        check(a, b);
+    }
+
+    TEST_F(DistributedBoundariesExchange, UnpackOnArrival) {
+        auto a = make_storage();
+        auto b = make_storage();
+        cabc.exchange(unpack_on_arrival, a, bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, b));
+        check(a, b);
+    }
+
+    TEST_F(DistributedBoundariesExchange, StartWait) {
+        auto a = make_storage();
+        auto b = make_storage();
+        auto c = make_storage();
+
+        auto handle = cabc.start_exchange(a, bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, b));
+        EXPECT_THROW(cabc.start_exchange(c), std::runtime_error);
+        EXPECT_THROW(cabc.exchange(c), std::runtime_error);
+
+        // work on data not involved in the exchange while the messages are in flight
+        auto c_view = c->host_view();
+        for (int i = 0; i < d1; ++i)
+            for (int j = 0; j < d2; ++j)
+                for (int k = 0; k < d3; ++k)
+                    c_view(i, j, k) = triplet{i, j, k};
+
+        cabc.wait(handle);
+        EXPECT_THROW(cabc.wait(handle), std::runtime_error);
+        check(a, b);
+
+        cabc.exchange(a, bind_bc(value_boundary<triplet>{triplet{42, 42, 42}}, b));
+        check(a, b);
+
+        // one start/wait pair and one exchange
+        EXPECT_EQ(cabc.get_count_exchange(), 2);
+        EXPECT_EQ(cabc.get_count_overlap(), 1);
+    }
+} // namespace
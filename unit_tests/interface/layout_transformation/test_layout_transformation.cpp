@@ -96,6 +96,22 @@ namespace {
         });
     }
 
+    TEST(layout_transformation, 3D_permuted_layout_partial_tiles) {
+        for_each<envs_t>([](auto env) {
+            constexpr size_t Nx = 70, Ny = 3, Nz = 67;
+            float src[Nx][Ny][Nz];
+            float dst[Ny][Nz][Nx];
+            auto dims = make_array(Nx, Ny, Nz);
+            for (auto i : make_hypercube_view(dims)) {
+                src[i[0]][i[1]][i[2]] = 1000 * i[0] + 100 * i[1] + i[2];
+                dst[i[1]][i[2]][i[0]] = -1;
+            }
+            testee(env, dst, src, dims, make_array(1, Nz * Nx, Nx), make_array(Ny * Nz, Nz, 1));
+            for (auto i : make_hypercube_view(dims))
+                EXPECT_FLOAT_EQ(dst[i[1]][i[2]][i[0]], src[i[0]][i[1]][i[2]]);
+        });
+    }
+
     TEST(layout_transformation, 2D_reverse_layout) {
         for_each<envs_t>([](auto env) {
             constexpr size_t Nx = 4, Ny = 5;
@@ -13,6 +13,7 @@
 #include <cpp_bindgen/fortran_array_view.hpp>
 #include <gridtools/interface/fortran_array_adapter.hpp>
 #include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/mc.hpp>
 #include <gridtools/storage/x86.hpp>
 #include <gridtools/tools/backend_select.hpp>
 
@@ -88,3 +89,147 @@ TEST(FortranArrayAdapter, TransformDataStoreIntoAdapter) {
             for (size_t x = 0; x < x_size; ++x, ++i)
                 EXPECT_EQ(fortran_array[z][y][x], i);
 }
+
+namespace {
+    // fills the 3D SID with the values of the Fortran array used in the tests, through the SID interface
+    template <class Sid>
+    void fill_sid(Sid const &sid, size_t x_size, size_t y_size, size_t z_size) {
+        using namespace gridtools;
+        auto strides = sid::get_strides(sid);
+        int i = 0;
+        for (size_t z = 0; z < z_size; ++z)
+            for (size_t y = 0; y < y_size; ++y)
+                for (size_t x = 0; x < x_size; ++x, ++i) {
+                    auto ptr = sid::get_origin(sid)();
+                    sid::shift(ptr, sid::get_stride<integral_constant<int, 0>>(strides), x);
+                    sid::shift(ptr, sid::get_stride<integral_constant<int, 1>>(strides), y);
+                    sid::shift(ptr, sid::get_stride<integral_constant<int, 2>>(strides), z);
+                    *ptr = i;
+                }
+    }
+} // namespace
+
+TEST(FortranArrayAdapter, AdapterIsSid) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    float_type fortran_array[y_size][x_size];
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 2;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.type = std::is_same<float_type, float>::value ? bindgen_fk_Float : bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    // the third dimension is masked
+    using data_store_t = decltype(builder.selector<1, 1, 0>().dimensions(x_size, y_size, 3)());
+    gridtools::fortran_array_adapter<data_store_t> adapter{descriptor};
+    static_assert(gridtools::is_sid<decltype(adapter)>::value, "");
+
+    auto strides = gridtools::sid::get_strides(adapter);
+    EXPECT_EQ(gridtools::tuple_util::get<0>(strides), 1);
+    EXPECT_EQ(gridtools::tuple_util::get<1>(strides), x_size);
+    EXPECT_EQ(gridtools::tuple_util::get<2>(strides), 0);
+    EXPECT_EQ(gridtools::sid::get_origin(adapter)(), &fortran_array[0][0]);
+
+    auto upper_bounds = gridtools::sid::get_upper_bounds(adapter);
+    EXPECT_EQ((gridtools::at_key<gridtools::integral_constant<int, 0>>(upper_bounds)), x_size);
+    EXPECT_EQ((gridtools::at_key<gridtools::integral_constant<int, 1>>(upper_bounds)), y_size);
+
+    fill_sid(adapter, x_size, y_size, 1);
+    int i = 0;
+    for (size_t y = 0; y < y_size; ++y)
+        for (size_t x = 0; x < x_size; ++x, ++i)
+            EXPECT_EQ(fortran_array[y][x], i);
+}
+
+TEST(FortranArrayAdapter, AdoptOrTransform) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    float_type fortran_array[z_size][y_size][x_size];
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = std::is_same<float_type, float>::value ? bindgen_fk_Float : bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    auto check = [&] {
+        int i = 0;
+        for (size_t z = 0; z < z_size; ++z)
+            for (size_t y = 0; y < y_size; ++y)
+                for (size_t x = 0; x < x_size; ++x, ++i) {
+                    EXPECT_EQ(fortran_array[z][y][x], i);
+                    fortran_array[z][y][x] = -1;
+                }
+    };
+
+    // the Fortran layout is used directly
+    auto fortran_layout_builder = builder.layout<2, 1, 0>().dimensions(x_size, y_size, z_size);
+    gridtools::fortran_array_adapter<decltype(fortran_layout_builder())> fortran_layout_adapter{descriptor};
+    EXPECT_TRUE(fortran_layout_adapter.is_adoptable());
+    bool adopted = false;
+    fortran_layout_adapter.adopt_or_transform(fortran_layout_builder, [&](auto const &sid) {
+        adopted = std::is_same<std::decay_t<decltype(sid)>, decltype(fortran_layout_adapter)>::value;
+        fill_sid(sid, x_size, y_size, z_size);
+    });
+    EXPECT_TRUE(adopted);
+    check();
+
+    // the default layout has a different order of the strides, the array is copied
+    auto default_builder = builder.dimensions(x_size, y_size, z_size);
+    gridtools::fortran_array_adapter<decltype(default_builder())> default_adapter{descriptor};
+    EXPECT_FALSE(default_adapter.is_adoptable());
+    default_adapter.adopt_or_transform(default_builder, [&](auto const &sid) {
+        adopted = std::is_same<std::decay_t<decltype(sid)>, decltype(default_adapter)>::value;
+        fill_sid(sid, x_size, y_size, z_size);
+    });
+    EXPECT_FALSE(adopted);
+    check();
+}
+
+TEST(FortranArrayAdapter, AdoptOrTransformMisaligned) {
+    constexpr size_t x_size = 6;
+    constexpr size_t y_size = 5;
+    constexpr size_t z_size = 4;
+    constexpr size_t size = x_size * y_size * z_size;
+    // the mc storage aligns to 64 bytes, the array starts one element after an aligned address
+    alignas(64) float_type buffer[size + 1];
+    float_type *fortran_array = buffer + 1;
+
+    bindgen_fortran_array_descriptor descriptor;
+    descriptor.rank = 3;
+    descriptor.dims[0] = x_size;
+    descriptor.dims[1] = y_size;
+    descriptor.dims[2] = z_size;
+    descriptor.type = std::is_same<float_type, float>::value ? bindgen_fk_Float : bindgen_fk_Double;
+    descriptor.data = fortran_array;
+    descriptor.is_acc_present = false;
+
+    for (size_t i = 0; i < size; ++i)
+        fortran_array[i] = -1;
+
+    auto mc_builder = gridtools::storage::builder<gridtools::storage::mc>
+                          .type<float_type>()
+                          .layout<2, 1, 0>()
+                          .dimensions(x_size, y_size, z_size);
+    gridtools::fortran_array_adapter<decltype(mc_builder())> adapter{descriptor};
+    EXPECT_FALSE(adapter.is_adoptable());
+    bool adopted = false;
+    adapter.adopt_or_transform(mc_builder, [&](auto const &sid) {
+        adopted = std::is_same<std::decay_t<decltype(sid)>, decltype(adapter)>::value;
+        fill_sid(sid, x_size, y_size, z_size);
+    });
+    EXPECT_FALSE(adopted);
+    for (size_t i = 0; i < size; ++i)
+        EXPECT_EQ(fortran_array[i], i);
+
+    // the same array at the aligned address is used directly
+    descriptor.data = buffer;
+    EXPECT_TRUE(adapter.is_adoptable());
+}
@@ -0,0 +1,91 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/sid/allocator.hpp>
+
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/meta.hpp>
+
+namespace gridtools {
+    namespace {
+        struct counting_alloc_f {
+            static size_t s_calls;
+            static size_t s_bytes;
+
+            std::unique_ptr<char[]> operator()(size_t size) const {
+                ++s_calls;
+                s_bytes += size;
+                return std::make_unique<char[]>(size);
+            }
+        };
+        size_t counting_alloc_f::s_calls = 0;
+        size_t counting_alloc_f::s_bytes = 0;
+
+        struct allocator : testing::Test {
+            allocator() {
+                counting_alloc_f::s_calls = 0;
+                counting_alloc_f::s_bytes = 0;
+            }
+        };
+
+        TEST_F(allocator, allocates_once) {
+            auto alloc = sid::make_allocator(counting_alloc_f());
+            allocate(alloc, meta::lazy::id<double>(), 10);
+            allocate(alloc, meta::lazy::id<int>(), 3);
+            EXPECT_EQ(counting_alloc_f::s_calls, 2);
+            EXPECT_EQ(counting_alloc_f::s_bytes, 10 * sizeof(double) + 3 * sizeof(int));
+        }
+
+        struct other_alloc_f : counting_alloc_f {};
+
+        TEST_F(allocator, arena) {
+            auto run = [](bool fresh) {
+                auto alloc = sid::make_arena_allocator(other_alloc_f());
+                auto a = allocate(alloc, meta::lazy::id<double>(), 1000)();
+                auto b = allocate(alloc, meta::lazy::id<double>(), 1000)();
+                auto c = allocate(alloc, meta::lazy::id<char>(), 1)();
+                EXPECT_EQ(is_fresh(alloc, a), fresh);
+                EXPECT_EQ(is_fresh(alloc, b), fresh);
+                EXPECT_EQ(is_fresh(alloc, c), fresh);
+                a[999] = 1;
+                b[999] = 2;
+                *c = 3;
+                EXPECT_EQ(a[999], 1);
+                EXPECT_EQ(b[999], 2);
+                EXPECT_EQ(*c, 3);
+
+                // buffers do not overlap and do not alias modulo the page size
+                auto pa = reinterpret_cast<std::uintptr_t>(a);
+                auto pb = reinterpret_cast<std::uintptr_t>(b);
+                auto pc = reinterpret_cast<std::uintptr_t>(c);
+                EXPECT_TRUE(pb >= pa + 1000 * sizeof(double) || pa >= pb + 1000 * sizeof(double));
+                EXPECT_NE(pa % 4096, pb % 4096);
+                EXPECT_NE(pb % 4096, pc % 4096);
+            };
+
+            // the first run does not know the total size yet
+            run(true);
+            EXPECT_EQ(counting_alloc_f::s_calls, 3);
+
+            // the second run allocates a single slab of the right size
+            run(true);
+            EXPECT_EQ(counting_alloc_f::s_calls, 4);
+
+            // later runs reuse the slab
+            run(false);
+            run(false);
+            EXPECT_EQ(counting_alloc_f::s_calls, 4);
+        }
+    } // namespace
+} // namespace gridtools
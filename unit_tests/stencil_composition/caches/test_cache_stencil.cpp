@@ -113,6 +113,27 @@ namespace gridtools {
 
                 expected = [this](int i, int j, int k) { return in(i, j, k) + 4; };
             }
+
+            TEST_F(cache_stencil, ij_cache_with_forward) {
+                run(
+                    [](auto in, auto out) {
+                        GT_DECLARE_TMP(float_type, tmp0, tmp1);
+                        return multi_pass(execute_parallel()
+                                              .ij_cached(tmp0)
+                                              .stage(functor1(), in, tmp0)
+                                              .stage(functor2(), tmp0, tmp1),
+                            execute_forward().stage(functor3(), tmp1, out));
+                    },
+                    backend_t(),
+                    make_grid(),
+                    make_storage(in),
+                    out);
+
+                expected = [this](int i, int j, int k) {
+                    return (in(i - 1, j, k) + in(i + 1, j, k) + in(i, j - 1, k) + in(i, j + 1, k)) / (float_type)4.0 +
+                           1;
+                };
+            }
         } // namespace
     }     // namespace cartesian
-} // namespace gridtools
\ No newline at end of file
+} // namespace gridtools
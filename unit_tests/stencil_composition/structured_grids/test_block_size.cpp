@@ -0,0 +1,110 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/cartesian.hpp>
+#include <gridtools/stencil_composition/common/block_size_tuner.hpp>
+#include <gridtools/tools/cartesian_fixture.hpp>
+
+#if defined(GT_BACKEND_X86) || defined(GT_BACKEND_MC)
+
+using namespace gridtools;
+using namespace cartesian;
+
+#ifdef GT_BACKEND_X86
+using runtime_backend_t = x86::backend<int_t, int_t>;
+#else
+using runtime_backend_t = mc::backend<>;
+#endif
+
+struct lap {
+    using out = inout_accessor<0>;
+    using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+
+    using param_list = make_param_list<out, in>;
+
+    template <class Eval>
+    GT_FUNCTION static void apply(Eval &&eval) {
+        eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+    }
+};
+
+struct copy {
+    using out = inout_accessor<0>;
+    using in = in_accessor<1>;
+
+    using param_list = make_param_list<out, in>;
+
+    template <class Eval>
+    GT_FUNCTION static void apply(Eval &&eval) {
+        eval(out()) = eval(in());
+    }
+};
+
+const auto spec = [](auto in, auto out) {
+    GT_DECLARE_TMP(float_type, tmp);
+    return execute_parallel().stage(lap(), tmp, in).stage(copy(), out, tmp);
+};
+
+struct block_size : computation_fixture<1> {
+    block_size() : computation_fixture<1>(13, 9, 7) {}
+
+    static float_type in(int i, int j, int k) { return i * i + 3 * j - k; }
+
+    void verify_lap(storage_type const &out) {
+        auto lap = [](int i, int j, int k) {
+            return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+        };
+        computation_fixture<1>::verify(lap, out);
+    }
+};
+
+TEST_F(block_size, run_time) {
+    for (auto bs : {std::make_pair(0, 0), std::make_pair(1, 1), std::make_pair(3, 5), std::make_pair(100, 2)}) {
+        auto out = make_storage();
+        run(spec, runtime_backend_t{bs.first, bs.second}, make_grid(), make_storage(in), out);
+        verify_lap(out);
+    }
+}
+
+TEST_F(block_size, tuner) {
+    std::string filename = "test_block_size_tuner.txt";
+    std::remove(filename.c_str());
+    std::vector<block_size_tuner::block_size_t> candidates = {{0, 0}, {4, 2}, {16, 16}};
+    block_size_tuner tuner(candidates, filename);
+
+    // warm-up call and one call per candidate
+    for (size_t i = 0; i <= candidates.size(); ++i) {
+        EXPECT_TRUE(tuner.best().empty());
+        auto out = make_storage();
+        run(spec, runtime_backend_t{0, 0, &tuner}, make_grid(), make_storage(in), out);
+        verify_lap(out);
+    }
+    auto best = tuner.best();
+    ASSERT_EQ(best.size(), 1);
+    EXPECT_NE(std::find(candidates.begin(), candidates.end(), best.begin()->second), candidates.end());
+
+    // tuned result is used
+    auto out = make_storage();
+    run(spec, runtime_backend_t{0, 0, &tuner}, make_grid(), make_storage(in), out);
+    verify_lap(out);
+
+    // tuned result is persisted
+    block_size_tuner loaded(candidates, filename);
+    EXPECT_EQ(loaded.best(), best);
+    std::remove(filename.c_str());
+}
+
+#endif
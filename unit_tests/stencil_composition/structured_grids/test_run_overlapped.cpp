@@ -0,0 +1,98 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil_composition/cartesian.hpp>
+#include <gridtools/tools/cartesian_fixture.hpp>
+
+namespace gridtools {
+    namespace cartesian {
+        namespace {
+            struct lap {
+                using out = inout_accessor<0>;
+                using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+
+                using param_list = make_param_list<out, in>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = 4 * eval(in()) - eval(in(1, 0)) - eval(in(-1, 0)) - eval(in(0, 1)) - eval(in(0, -1));
+                }
+            };
+
+            struct shift {
+                using out = inout_accessor<0>;
+                using in = in_accessor<1, extent<0, 1, -2, 0>>;
+
+                using param_list = make_param_list<out, in>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(in(1, -2));
+                }
+            };
+
+            const auto spec = [](auto out, auto in) {
+                GT_DECLARE_TMP(float_type, tmp);
+                return execute_parallel().stage(lap(), tmp, in).stage(shift(), out, tmp);
+            };
+
+            struct run_overlapped_fixture : computation_fixture<3> {
+                run_overlapped_fixture() : computation_fixture<3>(20, 16, 7) {}
+
+                static float_type in(int i, int j, int k) { return i * i + 3 * j * j - k; }
+
+                // written into the halos until the exchange completes, any use before wait() spoils the result
+                static constexpr float_type poison = 1e10;
+
+                int calls = 0;
+                int started = -1;
+                int waited = -1;
+
+                void check(int i_size, int j_size) {
+                    auto in_halo = [&](int i, int j) { return i < 3 || i >= 3 + i_size || j < 3 || j >= 3 + j_size; };
+                    auto expected = make_storage();
+                    auto actual = make_storage();
+                    auto input =
+                        make_storage([&](int i, int j, int k) { return in_halo(i, j) ? poison : in(i, j, k); });
+                    auto exchange = [&] {
+                        auto view = input->host_view();
+                        for (int i = 0; i < d(0); ++i)
+                            for (int j = 0; j < d(1); ++j)
+                                for (int k = 0; k < k_size(); ++k)
+                                    if (in_halo(i, j))
+                                        view(i, j, k) = in(i, j, k);
+                    };
+                    auto grid = make_grid().horizontal_region(0, i_size, 0, j_size);
+                    run(spec, backend_t(), grid, expected, make_storage(in));
+                    run_overlapped(
+                        spec,
+                        backend_t(),
+                        grid,
+                        [&] { started = calls++; },
+                        [&] {
+                            waited = calls++;
+                            exchange();
+                        },
+                        actual,
+                        input);
+                    EXPECT_EQ(started, 0);
+                    EXPECT_EQ(waited, 1);
+                    verify(expected, actual);
+                }
+            };
+
+            TEST_F(run_overlapped_fixture, interior_and_strips) { check(14, 10); }
+
+            TEST_F(run_overlapped_fixture, no_interior) { check(2, 10); }
+        } // namespace
+    }     // namespace cartesian
+} // namespace gridtools
@@ -0,0 +1,126 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/meta.hpp>
+#include <gridtools/stencil_composition/be_api.hpp>
+#include <gridtools/stencil_composition/cartesian.hpp>
+#include <gridtools/tools/cartesian_fixture.hpp>
+
+namespace gridtools {
+    namespace cartesian {
+        namespace {
+            // runs the computation with the backend under test and records the number of temporary buffers
+            struct counting_backend {
+                static int s_tmp_buffers;
+
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(
+                    counting_backend, Spec, Grid const &grid, DataStores external_data_stores) {
+                    using stages_t = be_api::make_split_view<Spec>;
+                    using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
+                    s_tmp_buffers = meta::length<be_api::tmp_buffers<stages_t, tmp_plh_map_t>>::value;
+                    gridtools_backend_entry_point(backend_t(), Spec(), grid, std::move(external_data_stores));
+                }
+            };
+
+            int counting_backend::s_tmp_buffers = -1;
+
+            struct tmp_aliasing : computation_fixture<1> {
+                tmp_aliasing() : computation_fixture<1>(13, 9, 7) {}
+
+                static float_type in(int i, int j, int k) { return i * i + 3 * j - k; }
+            };
+
+            struct inc {
+                using out = inout_accessor<0>;
+                using in = in_accessor<1>;
+
+                using param_list = make_param_list<out, in>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(in()) + 1;
+                }
+            };
+
+            struct sum {
+                using out = inout_accessor<0>;
+                using in0 = in_accessor<1>;
+                using in1 = in_accessor<2>;
+
+                using param_list = make_param_list<out, in0, in1>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(in0()) + eval(in1());
+                }
+            };
+
+            TEST_F(tmp_aliasing, chain) {
+                auto out = make_storage();
+                run(
+                    [](auto in, auto out) {
+                        GT_DECLARE_TMP(float_type, a, b, c, d);
+                        return multi_pass(execute_parallel().stage(inc(), a, in),
+                            execute_parallel().stage(inc(), b, a),
+                            execute_parallel().stage(inc(), c, b),
+                            execute_parallel().stage(inc(), d, c),
+                            execute_parallel().stage(inc(), out, d));
+                    },
+                    counting_backend(),
+                    make_grid(),
+                    make_storage(in),
+                    out);
+                EXPECT_EQ(counting_backend::s_tmp_buffers, 2);
+                verify([](int i, int j, int k) { return in(i, j, k) + 5; }, out);
+            }
+
+            TEST_F(tmp_aliasing, live_temporary) {
+                auto out = make_storage();
+                run(
+                    [](auto in, auto out) {
+                        GT_DECLARE_TMP(float_type, a, b, c);
+                        return multi_pass(execute_parallel().stage(inc(), a, in),
+                            execute_parallel().stage(inc(), b, a),
+                            execute_parallel().stage(inc(), c, b),
+                            execute_parallel().stage(sum(), out, a, c));
+                    },
+                    counting_backend(),
+                    make_grid(),
+                    make_storage(in),
+                    out);
+                EXPECT_EQ(counting_backend::s_tmp_buffers, 3);
+                verify([](int i, int j, int k) { return 2 * in(i, j, k) + 4; }, out);
+            }
+
+            TEST_F(tmp_aliasing, different_types) {
+                auto out = make_storage();
+                run(
+                    [](auto in, auto out) {
+                        GT_DECLARE_TMP(float_type, a, b);
+                        GT_DECLARE_TMP(int, c);
+                        return multi_pass(execute_parallel().stage(inc(), a, in),
+                            execute_parallel().stage(inc(), b, a),
+                            execute_parallel().stage(inc(), c, b),
+                            execute_parallel().stage(inc(), out, c));
+                    },
+                    counting_backend(),
+                    make_grid(),
+                    make_storage(in),
+                    out);
+                EXPECT_EQ(counting_backend::s_tmp_buffers, 3);
+                verify([](int i, int j, int k) { return in(i, j, k) + 4; }, out);
+            }
+        } // namespace
+    }     // namespace cartesian
+} // namespace gridtools
@@ -0,0 +1,52 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil_composition/backend/mc/ij_cache.hpp>
+
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+using namespace gridtools;
+using namespace gridtools::mc;
+
+namespace {
+    std::size_t plane_bytes(int_t i_size, int_t j_size) { return (i_size + 2) * (j_size + 2) * sizeof(double); }
+
+    TEST(ij_cache_mc, fitting_block_is_kept) {
+        int_t i_block_size = 64, j_block_size = 16;
+        fit_block_to_cache(i_block_size, j_block_size, plane_bytes, 1 << 20);
+        EXPECT_EQ(i_block_size, 64);
+        EXPECT_EQ(j_block_size, 16);
+    }
+
+    TEST(ij_cache_mc, j_is_reduced_first) {
+        int_t i_block_size = 256, j_block_size = 256;
+        fit_block_to_cache(i_block_size, j_block_size, plane_bytes, 256 * 1024);
+        EXPECT_EQ(i_block_size, 256);
+        EXPECT_LE(plane_bytes(i_block_size, j_block_size), 256 * 1024);
+        EXPECT_GT(plane_bytes(i_block_size, 2 * j_block_size), 256 * 1024);
+    }
+
+    TEST(ij_cache_mc, i_is_reduced_for_small_j) {
+        int_t i_block_size = 1024, j_block_size = 64;
+        fit_block_to_cache(i_block_size, j_block_size, plane_bytes, 32 * 1024);
+        EXPECT_EQ(j_block_size, 8);
+        EXPECT_LT(i_block_size, 1024);
+        EXPECT_LE(plane_bytes(i_block_size, j_block_size), 32 * 1024);
+    }
+
+    TEST(ij_cache_mc, minimal_block) {
+        int_t i_block_size = 1024, j_block_size = 1024;
+        fit_block_to_cache(i_block_size, j_block_size, plane_bytes, 0);
+        EXPECT_EQ(i_block_size, 32);
+        EXPECT_EQ(j_block_size, 1);
+    }
+} // namespace
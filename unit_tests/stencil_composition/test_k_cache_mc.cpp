@@ -0,0 +1,92 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2019, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil_composition/backend/mc/k_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hymap.hpp>
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/omp.hpp>
+#include <gridtools/meta.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/stencil_composition/be_api.hpp>
+#include <gridtools/stencil_composition/common/caches.hpp>
+#include <gridtools/stencil_composition/common/extent.hpp>
+
+using namespace gridtools;
+using namespace gridtools::mc;
+
+namespace {
+    struct plh_a;
+    struct plh_b;
+
+    using info_a_t = be_api::plh_info<meta::list<plh_a, cache_type::k>,
+        std::true_type,
+        double,
+        integral_constant<int_t, 1>,
+        std::false_type,
+        extent<0, 0, 0, 0, -1, 1>,
+        meta::list<>>;
+    using info_b_t = be_api::plh_info<meta::list<plh_b>,
+        std::true_type,
+        float,
+        integral_constant<int_t, 1>,
+        std::false_type,
+        extent<>,
+        meta::list<>>;
+
+    using key_a_t = info_a_t::key_t;
+
+    constexpr int_t i_size = 10;
+
+    double f(int_t i, int_t k, int_t t) { return i + k * 100 + t * 1000; }
+
+    template <class Step>
+    void check_slide(Step step) {
+        tmp_allocator_mc allocator;
+        auto caches =
+            make_k_caches<meta::list<key_a_t>>(meta::list<info_a_t, info_b_t>(), allocator, i_size);
+
+        auto k_stride = sid::get_stride<dim::k>(sid::get_strides(caches.sid()));
+        EXPECT_GE(k_stride, i_size);
+        EXPECT_EQ(k_stride % 8, 0);
+
+#pragma omp parallel
+        {
+            int_t t = omp_get_thread_num();
+            auto ptrs = caches.ptrs();
+            static_assert(tuple_util::size<decltype(ptrs)>::value == 1, "");
+            double *ptr = at_key<key_a_t>(ptrs);
+            for (int_t k = -1; k <= 1; ++k)
+                for (int_t i = 0; i < i_size; ++i)
+                    ptr[k * k_stride + i] = f(i, k, t);
+
+            caches.slide(step, ptrs, i_size);
+
+            // the value that was at level `k + step` is now at level `k`
+            for (int_t k = -1; k <= 1; ++k) {
+                if (k + Step::value < -1 || k + Step::value > 1)
+                    continue;
+                for (int_t i = 0; i < i_size; ++i)
+                    EXPECT_EQ(ptr[k * k_stride + i], f(i, k + Step::value, t));
+            }
+        }
+    }
+
+    TEST(k_cache_mc, slide_forward) { check_slide(integral_constant<int_t, 1>()); }
+
+    TEST(k_cache_mc, slide_backward) { check_slide(integral_constant<int_t, -1>()); }
+
+    TEST(k_cache_mc, is_k_cached) {
+        static_assert(is_k_cached<info_a_t>::value, "");
+        static_assert(!is_k_cached<info_b_t>::value, "");
+    }
+} // namespace
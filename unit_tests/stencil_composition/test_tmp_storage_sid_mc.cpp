@@ -37,6 +37,17 @@ TEST(tmp_storage_sid_mc, allocator) {
     }
 }
 
+TEST(tmp_storage_sid_mc, other_allocator) {
+    using extent_t = extent<-1, 2, -2, 3, 0, 0>;
+    pos3<std::size_t> block_size{12, 5, 1};
+
+    // an allocator that does not reuse memory, its temporaries are always first-touched
+    auto allocator = sid::make_allocator(make_hugepage_unique_f());
+    EXPECT_TRUE(sid::is_fresh(allocator, nullptr));
+    auto tmp = make_tmp_storage_mc<double, extent_t, true>(allocator, block_size);
+    static_assert(is_sid<decltype(tmp)>(), "");
+}
+
 TEST(tmp_storage_sid_mc, nonzero_k_extents) {
     using extent_t = extent<-1, 2, -2, 3, -1, 2>;
     pos3<std::size_t> block_size{12, 2, 8};